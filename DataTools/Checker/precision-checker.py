@@ -0,0 +1,134 @@
+#####################################################################################################
+#####################################################################################################
+# Compares outcome statistics of runs with rounded genes (GENE_ROUNDING=1/2) against unrounded runs
+#
+# Each directory holds one sub directory per replicate with a data.csv file inside
+# For every column the value at the chosen generation is collected across replicates
+# Columns whose distributions differ (Mann-Whitney U, normal approximation, Bonferroni corrected) are flagged
+#
+# Command Line Inputs
+#
+# Input 1: directory with the double precision replicates
+# Input 2: directory with the reduced precision replicates
+# Input 3: generation to compare at (optional, defaults to the last generation in each file)
+# Input 4: significance level (optional, defaults to 0.05)
+#
+# Output : table of per column means/stds + p-values in terminal display, exit code 1 if any flagged
+#
+# python3
+#####################################################################################################
+#####################################################################################################
+
+
+######################## IMPORTS ########################
+import argparse
+import pandas as pd
+import numpy as np
+import math
+import glob
+import sys
+import os
+
+# outcome columns we care about
+COLUMNS = ['pop_fit_max', 'pop_opt_max', 'pop_uni_obj', 'ele_agg_per', 'ele_opt_cnt', 'com_agg_per', 'los_div', 'sel_pre']
+
+# value of every column at a generation, one row per replicate
+def Collect(dir, gen):
+    # check if data dir exists
+    if os.path.isdir(dir) == False:
+        sys.exit('DATA DIRECTORY DOES NOT EXIST: ' + dir)
+
+    rows = []
+    for file in sorted(glob.glob(os.path.join(dir, '*', 'data.csv'))):
+        df = pd.read_csv(file)
+        if gen is None:
+            row = df.iloc[-1]
+        elif gen in df['gen'].values:
+            row = df[df['gen'] == gen].iloc[0]
+        else:
+            print('SKIPPING (generation not found):', file)
+            continue
+        rows.append(row)
+
+    if len(rows) == 0:
+        sys.exit('NO REPLICATES FOUND IN: ' + dir)
+
+    return pd.DataFrame(rows)
+
+# two sided Mann-Whitney U test p-value (normal approximation with tie correction)
+def MannWhitney(x, y):
+    n1 = len(x)
+    n2 = len(y)
+    both = np.concatenate([x, y])
+
+    # average ranks for ties
+    order = np.argsort(both, kind='mergesort')
+    ranks = np.empty(len(both))
+    ranks[order] = np.arange(1, len(both) + 1)
+    vals, inv, cnt = np.unique(both, return_inverse=True, return_counts=True)
+    ranks = np.bincount(inv, weights=ranks)[inv] / cnt[inv]
+
+    u = np.sum(ranks[:n1]) - n1 * (n1 + 1) / 2.0
+    mu = n1 * n2 / 2.0
+    n = n1 + n2
+    var = n1 * n2 / 12.0 * ((n + 1) - np.sum(cnt**3 - cnt) / (n * (n - 1)))
+
+    # identical constant samples
+    if var <= 0.0:
+        return 1.0
+
+    z = (abs(u - mu) - 0.5) / math.sqrt(var)
+    return math.erfc(max(z, 0.0) / math.sqrt(2.0))
+
+def Compare(base, cand, alpha):
+    flagged = []
+    # one test per column
+    alpha = alpha / len(COLUMNS)
+    print('{:<14}{:>14}{:>14}{:>14}{:>14}{:>10}'.format('column', 'base_mean', 'base_std', 'prec_mean', 'prec_std', 'p'))
+
+    for col in COLUMNS:
+        if col not in base.columns or col not in cand.columns:
+            print('{:<14} MISSING'.format(col))
+            continue
+
+        x = base[col].to_numpy(dtype=float)
+        y = cand[col].to_numpy(dtype=float)
+        p = MannWhitney(x, y)
+        mark = ' *' if p < alpha else ''
+        print('{:<14}{:>14.4f}{:>14.4f}{:>14.4f}{:>14.4f}{:>10.4f}{}'.format(col, x.mean(), x.std(), y.mean(), y.std(), p, mark))
+
+        if p < alpha:
+            flagged.append(col)
+
+    return flagged
+
+def main():
+    # Generate and get the arguments
+    parser = argparse.ArgumentParser(description="Reduced precision validation script.")
+    parser.add_argument("baseline", type=str, help="Directory of double precision replicates.")
+    parser.add_argument("candidate", type=str, help="Directory of reduced precision replicates.")
+    parser.add_argument("generation", type=int, nargs='?', default=None, help="Generation to compare at.")
+    parser.add_argument("alpha", type=float, nargs='?', default=0.05, help="Significance level.")
+
+    # Parse all the arguments
+    args = parser.parse_args()
+    print('Baseline directory=', args.baseline)
+    print('Candidate directory=', args.candidate)
+    print('Generation=', 'last' if args.generation is None else args.generation)
+    print('Alpha=', args.alpha)
+
+    # Get to work!
+    base = Collect(args.baseline.strip(), args.generation)
+    cand = Collect(args.candidate.strip(), args.generation)
+    print('Replicates=', len(base), 'vs', len(cand), '\n')
+
+    flagged = Compare(base, cand, args.alpha)
+    print('')
+    if len(flagged) == 0:
+        print('No outcome differs from the double precision baseline')
+    else:
+        print('Differing outcomes:', ','.join(flagged))
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
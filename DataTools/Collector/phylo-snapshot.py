@@ -0,0 +1,167 @@
+#####################################################################################################
+#####################################################################################################
+# Reads binary phylogeny snapshots (phylo_<update>.bin) and converts them to the CSV snapshot format
+#
+# Layout is documented at the top of source/snapshot.h
+# Uncompressed files are memory mapped, deflated files (SNAP_COMPRESS=1) are read into memory
+# Delta snapshots (SNAP_DELTA) are rebuilt from the last full snapshot in the same directory
+#
+# Command Line Inputs
+#
+# Input 1: binary snapshot file
+# Input 2: csv file to write (optional, defaults to input with .csv extension)
+#
+# Output : csv snapshot matching emp::Systematics::Snapshot columns
+#
+# python3
+#####################################################################################################
+#####################################################################################################
+
+
+######################## IMPORTS ########################
+import argparse
+import numpy as np
+import zlib
+import glob
+import sys
+import os
+
+# snapshot constants (must match source/snapshot.h), files are little-endian on every host
+MAGIC = b'DIAPHYLO'
+VERSION = 1
+SNAP_ZLIB = 1
+SNAP_DELTA = 2
+NO_PARENT = np.iinfo(np.uint64).max
+HEADER = np.dtype([('magic', 'S8'), ('version', '<u4'), ('flags', '<u4'), ('update', '<u8'), ('taxa', '<u8'),
+                   ('geno_width', '<u8'), ('phen_width', '<u8'), ('body_size', '<u8'), ('stored_size', '<u8')])
+
+# columns in file order: (name, dtype, values per row key)
+COLUMNS = [('id', '<u8', None), ('parent', '<u8', None), ('origin_time', '<f8', None), ('destruction_time', '<f8', None),
+           ('num_orgs', '<u8', None), ('tot_orgs', '<u8', None), ('num_offspring', '<u8', None),
+           ('total_offspring', '<u8', None), ('depth', '<u8', None), ('fitness', '<f8', None),
+           ('genotype', '<f8', 'geno_width'), ('phenotype', '<f8', 'phen_width')]
+
+# read and check the snapshot header
+def ReadHeader(file):
+    header = np.fromfile(file, dtype=HEADER, count=1)
+    if len(header) == 0 or header['magic'][0] != MAGIC:
+        sys.exit('NOT A BINARY SNAPSHOT FILE')
+    if header['version'][0] != VERSION:
+        sys.exit('UNKNOWN SNAPSHOT VERSION')
+
+    return {name: header[name][0] for name in HEADER.names}
+
+# return dictionary of column arrays (memory mapped when possible)
+def LoadSnapshot(file):
+    # check and make sure that the file exists
+    if os.path.isfile(file) == False:
+        sys.exit('SNAPSHOT FILE DOES NOT EXIST')
+
+    header = ReadHeader(file)
+    N = int(header['taxa'])
+
+    # deflated column block has to be read into memory
+    if header['flags'] & SNAP_ZLIB:
+        with open(file, 'rb') as f:
+            f.seek(HEADER.itemsize)
+            body = np.frombuffer(zlib.decompress(f.read(int(header['stored_size']))), dtype=np.uint8)
+    else:
+        body = np.memmap(file, dtype=np.uint8, mode='r', offset=HEADER.itemsize, shape=(int(header['body_size']),))
+
+    # slice each column out of the block
+    cols = {}
+    at = 0
+    for name, dtype, width in COLUMNS:
+        w = 1 if width is None else int(header[width])
+        size = N * w * 8
+        col = body[at:at+size].view(dtype)
+        cols[name] = col if width is None else col.reshape(N, w)
+        at += size
+
+    # delta tail: base update + removed ids
+    if header['flags'] & SNAP_DELTA:
+        tail = body[at:].view('<u8')
+        header['base_update'] = int(tail[0])
+        cols['removed'] = tail[2:2+int(tail[1])]
+
+    return header, cols
+
+# update a snapshot file was taken at (from its name)
+def FileUpdate(file):
+    return int(os.path.basename(file)[len('phylo_'):-len('.bin')])
+
+# rebuild the full tree at the update of a (possibly delta) snapshot
+def Reconstruct(file):
+    header, cols = LoadSnapshot(file)
+    if not header['flags'] & SNAP_DELTA:
+        return header, cols
+
+    # find the chain: last full snapshot before this one + every delta after it
+    files = sorted(glob.glob(os.path.join(os.path.dirname(file) or '.', 'phylo_*.bin')), key=FileUpdate)
+    files = [f for f in files if FileUpdate(f) <= header['update']]
+    chain = []
+    for f in reversed(files):
+        h, c = LoadSnapshot(f)
+        chain.append((h, c))
+        if not h['flags'] & SNAP_DELTA:
+            break
+    chain.reverse()
+
+    if chain[0][0]['flags'] & SNAP_DELTA:
+        sys.exit('NO FULL SNAPSHOT FOUND BEFORE DELTA')
+
+    # apply deltas in order: drop removed + changed ids, then add the delta rows
+    tree = {name: np.array(col) for name, col in chain[0][1].items()}
+    last = chain[0][0]['update']
+    for h, c in chain[1:]:
+        if h['base_update'] != last:
+            sys.exit('DELTA CHAIN BROKEN AT UPDATE ' + str(h['update']))
+        keep = ~np.isin(tree['id'], np.concatenate([c['removed'], c['id']]))
+        for name, _, _ in COLUMNS:
+            tree[name] = np.concatenate([tree[name][keep], c[name]])
+        last = h['update']
+
+    # rows sorted by id like a full snapshot
+    order = np.argsort(tree['id'], kind='stable')
+    for name, _, _ in COLUMNS:
+        tree[name] = tree[name][order]
+
+    header['taxa'] = len(tree['id'])
+    return header, tree
+
+# format a vector the same way emp::ToString does
+def VecString(v):
+    return '[ ' + ' '.join('{:g}'.format(x) for x in v if not np.isnan(x)) + ' ]'
+
+# write the csv snapshot
+def ExportCSV(cols, file):
+    with open(file, 'w') as f:
+        f.write('id,ancestor_list,origin_time,destruction_time,num_orgs,tot_orgs,num_offspring,total_offspring,depth,fitness,phenotype,genotype\n')
+        for i in range(len(cols['id'])):
+            parent = '[NONE]' if cols['parent'][i] == NO_PARENT else '[' + str(cols['parent'][i]) + ']'
+            row = [str(cols['id'][i]), parent, '{:g}'.format(cols['origin_time'][i]), '{:g}'.format(cols['destruction_time'][i]),
+                   str(cols['num_orgs'][i]), str(cols['tot_orgs'][i]), str(cols['num_offspring'][i]),
+                   str(cols['total_offspring'][i]), str(cols['depth'][i]), '{:g}'.format(cols['fitness'][i]),
+                   '"' + VecString(cols['phenotype'][i]) + '"', '"' + VecString(cols['genotype'][i]) + '"']
+            f.write(','.join(row) + '\n')
+
+def main():
+    # Generate and get the arguments
+    parser = argparse.ArgumentParser(description="Binary phylogeny snapshot converter.")
+    parser.add_argument("snapshot", type=str, help="Binary snapshot file (phylo_<update>.bin).")
+    parser.add_argument("csv",      type=str, nargs='?', default='', help="CSV file to write.")
+
+    # Parse all the arguments
+    args = parser.parse_args()
+    snapshot = args.snapshot.strip()
+    print('Snapshot file=', snapshot)
+    csv = args.csv.strip() if args.csv else os.path.splitext(snapshot)[0] + '.csv'
+    print('CSV file=', csv)
+
+    # Get to work!
+    header, cols = Reconstruct(snapshot)
+    print('Update=', header['update'], 'Taxa=', header['taxa'])
+    ExportCSV(cols, csv)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,117 @@
+#define CATCH_CONFIG_MAIN
+
+// testing files
+#include "/mnt/c/Users/josex/Desktop/Research/Repos/Catch/catch.hpp"
+#include "../source/checkpoint.h"
+
+// empirical headers
+#include "base/vector.h"
+
+// library includes
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// const vars for test
+const std::string PATH = "checkpoint-test.bin";
+const std::string CSV = "checkpoint-test.csv";
+
+// In Tests directory, to run:
+// clang++ -std=c++17 -I ../../../Empirical/source/ checkpoint-test.cpp -o checkpoint-test; ./checkpoint-test
+
+std::string Slurp(const std::string & path)
+{
+  std::ifstream in(path);
+  std::ostringstream all;
+  all << in.rdbuf();
+  return all.str();
+}
+
+void Spit(const std::string & path, const std::string & text)
+{
+  std::ofstream out(path, std::ios::trunc);
+  out << text;
+}
+
+TEST_CASE("Checkpoint round trip", "[checkpoint]")
+{
+  CheckpointHeader hdr;
+  hdr.update = 500; hdr.seed = 17; hdr.pop_size = 2; hdr.objectives = 3;
+  const emp::vector<double> genomes = {0.5, 1.25, 2.0, 3.5, 4.75, 6.0};
+  const emp::vector<double> amounts = {1.0, 0.0, 2.5};
+
+  CheckpointWriter out;
+  out.Put(hdr);
+  out.PutRaw(genomes.data(), genomes.size());
+  out.PutVec(amounts);
+  out.Put<uint64_t>(42);
+  REQUIRE(out.WriteFile(PATH));
+  REQUIRE(out.GetSize() == sizeof(CheckpointHeader) + 6 * sizeof(double) + 8 + 3 * sizeof(double) + 8);
+
+  CheckpointReader in;
+  REQUIRE(in.ReadFile(PATH));
+  const CheckpointHeader got = in.Get<CheckpointHeader>();
+  REQUIRE(got.IsValid());
+  REQUIRE(got.update == 500); REQUIRE(got.seed == 17);
+  REQUIRE(got.pop_size == 2); REQUIRE(got.objectives == 3);
+
+  emp::vector<double> back(genomes.size());
+  in.GetRaw(back.data(), back.size());
+  REQUIRE(back == genomes);
+  REQUIRE(in.GetVec() == amounts);
+  REQUIRE(in.Get<uint64_t>() == 42);
+  REQUIRE(in.Ok());
+  REQUIRE(in.Done());
+
+  // reading past the end is flagged, not undefined
+  in.Get<uint64_t>();
+  REQUIRE(!in.Ok());
+
+  std::remove(PATH.c_str());
+}
+
+TEST_CASE("Checkpoint rejects foreign files", "[checkpoint]")
+{
+  CheckpointReader in;
+  REQUIRE(!in.ReadFile("no-such-checkpoint.bin"));
+
+  // too short to hold a header
+  Spit(PATH, "not a checkpoint");
+  REQUIRE(in.ReadFile(PATH));
+  in.Get<CheckpointHeader>();
+  REQUIRE(!in.Ok());
+
+  // long enough, wrong magic
+  Spit(PATH, std::string(sizeof(CheckpointHeader), 'x'));
+  REQUIRE(in.ReadFile(PATH));
+  REQUIRE(!in.Get<CheckpointHeader>().IsValid());
+  REQUIRE(in.Ok());
+
+  std::remove(PATH.c_str());
+}
+
+TEST_CASE("Csv files are cut back to the resume update", "[checkpoint]")
+{
+  // rows from updates before and after the checkpoint at 20
+  Spit(CSV, "update,id\n0,1\n10,2\n20,3\n30,4\n");
+  REQUIRE(CsvRows(CSV, true, 20) == "update,id\n0,1\n10,2\n");
+  REQUIRE(CsvRows(CSV, false, 20) == "0,1\n10,2\n");
+
+  // resumed run writes its own rows aside, then they are appended at the end
+  REQUIRE(ResumeCsv(CSV, 20));
+  REQUIRE(Slurp(CSV) == "update,id\n0,1\n10,2\n");
+  Spit(CSV + ".resume", "update,id\n20,3\n30,4\n40,5\n");
+
+  // killed again and resumed from 30: earlier resume rows are folded back in
+  REQUIRE(ResumeCsv(CSV, 30));
+  REQUIRE(Slurp(CSV) == "update,id\n0,1\n10,2\n20,3\n");
+  REQUIRE(!std::ifstream(CSV + ".resume").is_open());
+
+  Spit(CSV + ".resume", "update,id\n30,4\n40,5\n");
+  REQUIRE(FinishCsv(CSV));
+  REQUIRE(Slurp(CSV) == "update,id\n0,1\n10,2\n20,3\n30,4\n40,5\n");
+  REQUIRE(!std::ifstream(CSV + ".resume").is_open());
+
+  std::remove(CSV.c_str());
+}
@@ -0,0 +1,145 @@
+#define CATCH_CONFIG_MAIN
+
+// testing files
+#include "/mnt/c/Users/josex/Desktop/Research/Repos/Catch/catch.hpp"
+#include "../source/ecoea.h"
+
+// empirical headers
+#include "base/vector.h"
+#include "Evolve/Resource.h"
+#include "tools/Random.h"
+
+// library includes
+#include <algorithm>
+#include <cmath>
+
+// const vars for test
+constexpr size_t N = 64;
+constexpr size_t M = 20;
+constexpr size_t GENS = 25;
+constexpr double INFLOW = 2000.0;
+constexpr double FRAC = 0.0025;
+constexpr double MAX_BONUS = 5.0;
+constexpr double COST = 0.0;
+constexpr double NICHE = 0.0;
+
+// In Tests directory, to run:
+// clang++ -std=c++17 -I ../../../Empirical/source/ ecoea-test.cpp -o ecoea-test; ./ecoea-test
+
+// the emp::ResourceSelect internals EcoEAEngine replaces
+emp::vector<double> Reference(emp::vector<emp::Resource> & pools, const emp::vector<emp::vector<double>> & scores, const emp::vector<double> & base, const emp::vector<bool> & occupied, const size_t live)
+{
+  emp::vector<double> fit(base.size(), 0.0);
+  for(size_t org_id = 0; org_id < base.size(); ++org_id)
+  {
+    if(!occupied[org_id]) {continue;}
+    fit[org_id] = base[org_id];
+    for(size_t ex_id = 0; ex_id < pools.size(); ++ex_id)
+    {
+      pools[ex_id].Inc(pools[ex_id].GetInflow() / live);
+      double cur_fit = scores[org_id][ex_id];
+      cur_fit = emp::Pow(cur_fit, 2.0);
+      cur_fit *= FRAC * (pools[ex_id].GetAmount() - COST);
+      if(cur_fit > NICHE) {cur_fit -= COST;}
+      else {cur_fit = 0;}
+      cur_fit = std::min(cur_fit, MAX_BONUS);
+      fit[org_id] *= emp::Pow2(cur_fit);
+      pools[ex_id].Dec(std::abs(cur_fit));
+    }
+  }
+
+  return fit;
+}
+
+TEST_CASE("EcoEA engine matches the resource select loop", "[ecoea]")
+{
+  emp::Random random(11);
+  EcoEAEngine engine(M, INFLOW, FRAC, MAX_BONUS, COST, NICHE);
+  emp::vector<emp::Resource> pools(M, emp::Resource(INFLOW, INFLOW, 0.0));
+
+  for(size_t g = 0; g < GENS; ++g)
+  {
+    emp::vector<emp::vector<double>> scores(N, emp::vector<double>(M));
+    emp::vector<double> base(N, 0.0);
+    emp::vector<bool> occupied(N, true);
+    size_t live = N;
+    // a few empty positions every generation
+    for(size_t k = 0; k < 3; ++k)
+    {
+      const size_t i = random.GetUInt(N);
+      if(occupied[i]) {occupied[i] = false; --live;}
+    }
+
+    engine.Resize(N);
+    for(size_t i = 0; i < N; ++i)
+    {
+      for(size_t j = 0; j < M; ++j) {scores[i][j] = random.GetDouble(0.0, 1.0);}
+      if(!occupied[i]) {continue;}
+      for(double s : scores[i]) {base[i] += s;}
+      std::copy(scores[i].begin(), scores[i].end(), engine.Row(i));
+    }
+
+    const emp::vector<double> expect = Reference(pools, scores, base, occupied, live);
+    const emp::vector<double> & got = engine.Fitness(base, live, &occupied);
+
+    // bit identical, fitnesses and levels
+    REQUIRE(got == expect);
+    for(size_t j = 0; j < M; ++j) {REQUIRE(engine.GetLevels()[j] == pools[j].GetAmount());}
+  }
+}
+
+TEST_CASE("EcoEA log space keeps the ordering without overflow", "[ecoea]")
+{
+  emp::Random random(5);
+
+  // small M: log2 of the product, same resource consumption
+  EcoEAEngine lin(M, INFLOW, FRAC, MAX_BONUS, COST, NICHE);
+  EcoEAEngine log(M, INFLOW, FRAC, MAX_BONUS, COST, NICHE);
+  log.SetLogSpace(true);
+  lin.Resize(N); log.Resize(N);
+
+  emp::vector<double> base(N);
+  for(size_t i = 0; i < N; ++i)
+  {
+    for(size_t j = 0; j < M; ++j) {lin.Row(i)[j] = log.Row(i)[j] = random.GetDouble(0.0, 1.0);}
+    base[i] = 1.0 + random.GetDouble(0.0, 10.0);
+  }
+  base[0] = 0.0;
+
+  const emp::vector<double> a = lin.Fitness(base, N);
+  const emp::vector<double> b = log.Fitness(base, N);
+  REQUIRE(lin.GetLevels() == log.GetLevels());
+  REQUIRE(std::isinf(b[0]));
+  for(size_t i = 1; i < N; ++i)
+  {
+    REQUIRE(b[i] == Approx(std::log2(a[i])));
+    for(size_t k = 1; k < N; ++k) {if(std::abs(b[i] - b[k]) > 1e-9) {REQUIRE((a[i] < a[k]) == (b[i] < b[k]));}}
+  }
+
+  // large M: products overflow to inf and tie, log space still tells them apart
+  constexpr size_t BIG = 2000;
+  EcoEAEngine lin_big(BIG, 1e6, 1.0, MAX_BONUS, COST, NICHE);
+  EcoEAEngine log_big(BIG, 1e6, 1.0, MAX_BONUS, COST, NICHE);
+  log_big.SetLogSpace(true);
+  lin_big.Resize(2); log_big.Resize(2);
+  for(size_t j = 0; j < BIG; ++j)
+  {
+    lin_big.Row(0)[j] = log_big.Row(0)[j] = 1.0;
+    lin_big.Row(1)[j] = log_big.Row(1)[j] = (j < BIG / 2) ? 1.0 : 0.0;
+  }
+
+  const emp::vector<double> c = lin_big.Fitness({1.0, 1.0}, 2);
+  const emp::vector<double> d = log_big.Fitness({1.0, 1.0}, 2);
+  REQUIRE(std::isinf(c[0])); REQUIRE(std::isinf(c[1]));
+  REQUIRE(std::isfinite(d[0])); REQUIRE(std::isfinite(d[1]));
+  REQUIRE(d[0] > d[1]);
+}
+
+TEST_CASE("EcoEA levels can be restored", "[ecoea]")
+{
+  EcoEAEngine engine(3, 1.0, FRAC, MAX_BONUS, COST, NICHE);
+  REQUIRE(engine.GetLevels() == emp::vector<double>{1.0, 1.0, 1.0});
+
+  engine.SetLevels({0.5, 2.0, 3.5});
+  REQUIRE(engine.GetLevels() == emp::vector<double>{0.5, 2.0, 3.5});
+}
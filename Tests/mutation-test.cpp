@@ -0,0 +1,91 @@
+#define CATCH_CONFIG_MAIN
+
+// testing files
+#include "/mnt/c/Users/josex/Desktop/Research/Repos/Catch/catch.hpp"
+#include "../source/mutation.h"
+
+// empirical headers
+#include "base/vector.h"
+#include "tools/Random.h"
+
+// library includes
+#include <algorithm>
+#include <cmath>
+
+// const vars for test
+constexpr size_t SEED = 17;
+constexpr size_t M = 100;
+constexpr double TARGET = 100.0;
+constexpr size_t M_RUNS = 20000;
+
+// In Tests directory, to run:
+// clang++ -std=c++17 -I ../../../Empirical/source/ mutation-test.cpp -o mutation-test; ./mutation-test
+
+TEST_CASE("Mutation kernel edge rates", "[edge]")
+{
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  emp::vector<double> genome(M, 50.0);
+
+  // nothing ever mutates
+  MutationKernel none(0.0, 0.0, 1.0, TARGET);
+  REQUIRE(none.Mutate(genome, *random) == 0);
+  REQUIRE(none.GetChanged().size() == 0);
+  REQUIRE(std::all_of(genome.begin(), genome.end(), [](double g) {return g == 50.0;}));
+
+  // everything mutates
+  MutationKernel all(1.0, 0.0, 1.0, TARGET);
+  REQUIRE(all.Mutate(genome, *random) == M);
+  for(size_t i = 0; i < M; ++i) {REQUIRE(all.GetChanged()[i] == i);}
+}
+
+TEST_CASE("Mutation kernel bounds", "[bounds]")
+{
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  MutationKernel kernel(1.0, 0.0, 5.0, TARGET);
+
+  for(size_t r = 0; r < 100; ++r)
+  {
+    // genes sitting on both boundaries
+    emp::vector<double> genome(M, 0.0);
+    for(size_t i = 0; i < M; i += 2) {genome[i] = TARGET;}
+    kernel.Mutate(genome, *random);
+
+    // clamped at zero and reflected under the target
+    for(const auto & g : genome) {REQUIRE(0.0 <= g); REQUIRE(g <= TARGET);}
+  }
+}
+
+TEST_CASE("Mutation kernel distribution", "[distribution]")
+{
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  const double rate = 0.05;
+  MutationKernel kernel(rate, 0.0, 1.0, TARGET);
+
+  double cnt = 0.0, sum = 0.0, sqr = 0.0;
+  emp::vector<double> hits(M, 0.0);
+  for(size_t r = 0; r < M_RUNS; ++r)
+  {
+    emp::vector<double> genome(M, 50.0);
+    cnt += kernel.Mutate(genome, *random);
+
+    // positions are ascending and unique
+    const auto & changed = kernel.GetChanged();
+    REQUIRE(std::is_sorted(changed.begin(), changed.end()));
+    REQUIRE(std::adjacent_find(changed.begin(), changed.end()) == changed.end());
+
+    for(const auto & i : changed)
+    {
+      const double d = genome[i] - 50.0;
+      sum += d; sqr += d * d; hits[i] += 1.0;
+    }
+  }
+
+  // same expected count as a bernoulli trial per gene
+  REQUIRE(cnt / M_RUNS == Approx(rate * M).epsilon(0.05));
+  // standard normal deltas
+  REQUIRE(sum / cnt == Approx(0.0).margin(0.05));
+  REQUIRE(sqr / cnt == Approx(1.0).epsilon(0.05));
+  // no positional bias between the first and last genes
+  REQUIRE(hits.front() / M_RUNS == Approx(rate).epsilon(0.2));
+  REQUIRE(hits.back() / M_RUNS == Approx(rate).epsilon(0.2));
+}
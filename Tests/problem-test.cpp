@@ -357,4 +357,40 @@ TEST_CASE("Problem class optimized vector function", "[opimized]")
   correct = {false,true,true,true,true,true,true,true,true,false};
   PrintVec(g, "g"); PrintVec(opti, "o"); PrintVec(correct, "c");
   REQUIRE_THAT(opti, Catch::Matchers::Equals(correct));
+}
+
+TEST_CASE("Fixed diagnostics match dynamic diagnostics", "[fixed]")
+{
+  // fixed objective count and a genome pool with ties, runs and plateaus
+  constexpr size_t M = 10; const double cred = 0.5; const double acc = 0.99;
+  emp::vector<double> tar(M, 10.0);
+  Diagnostic diag(tar, cred);
+  FixedDiagnostic<M> fixed(10.0, cred);
+
+  emp::vector<emp::vector<double>> genomes = {
+    {10,9,8,7,6,5,4,3,2,1}, {1,2,3,4,5,6,7,8,9,10}, {5,5,5,5,5,5,5,5,5,5},
+    {3,9.95,9.95,2,1,0,4,4,1,0}, {0,0,0,0,0,0,0,0,0,0}, {9.9,1,9.9,2,8,8,8,7,10,0.5}
+  };
+
+  for(const auto & g : genomes)
+  {
+    FixedDiagnostic<M>::score_t score; FixedDiagnostic<M>::opti_t opti;
+    auto same = [&score](const emp::vector<double> & s) {return std::equal(s.begin(), s.end(), score.begin());};
+
+    fixed.Exploration(g.data(), score);
+    REQUIRE(same(diag.Exploration(g)));
+    fixed.Exploitation(g.data(), score);
+    REQUIRE(same(diag.Exploitation(g)));
+    fixed.WeakEcology(g.data(), score);
+    REQUIRE(same(diag.WeakEcology(g)));
+    fixed.StrongEcology(g.data(), score);
+    REQUIRE(same(diag.StrongEcology(g)));
+    fixed.StructExploitation(g.data(), score);
+    REQUIRE(same(diag.StructExploitation(g)));
+
+    const auto correct = diag.OptimizedVector(g, acc);
+    const size_t cnt = fixed.OptimizedVector(g.data(), acc, opti);
+    REQUIRE(std::equal(correct.begin(), correct.end(), opti.begin()));
+    REQUIRE(cnt == static_cast<size_t>(std::count(correct.begin(), correct.end(), true)));
+  }
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#define CATCH_CONFIG_MAIN
+
+// testing files
+#include "/mnt/c/Users/josex/Desktop/Research/Repos/Catch/catch.hpp"
+#include "../source/config.h"
+#include "../source/world.h"
+
+// library includes
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// const vars for test
+const size_t MAX_GENS = 40;
+const emp::vector<std::string> FILES = {"data.csv", "phylodiversity.csv", "genotype_systematics.csv", "phenotype_systematics.csv", "phylo_40.csv"};
+
+// In Tests directory, to run:
+// clang++ -std=c++17 -pthread -I ../../../Empirical/include/ resume-test.cpp -o resume-test; ./resume-test
+
+using settings_t = emp::vector<std::pair<std::string, std::string>>;
+
+std::string Slurp(const std::string & path)
+{
+  std::ifstream in(path, std::ios::binary);
+  std::ostringstream all;
+  all << in.rdbuf();
+  return all.str();
+}
+
+// run a small lexicase world in dir until update stop (a world destroyed early stands in for a killed run)
+void Run(const std::string & dir, const settings_t & settings, const size_t stop)
+{
+  std::filesystem::create_directories(dir);
+
+  DiaConfig config;
+  config.Set("POP_SIZE", "64");
+  config.Set("OBJECTIVE_CNT", "10");
+  config.Set("MAX_GENS", std::to_string(MAX_GENS));
+  config.Set("SELECTION", "4");
+  config.Set("DATA_INTERVAL", "1");
+  config.Set("PRINT_INTERVAL", "0");
+  config.Set("SNAP_INTERVAL", "20");
+  config.Set("OUTPUT_DIR", dir);
+  for(const auto & s : settings) {config.Set(s.first, s.second);}
+
+  DiagWorld world(config);
+  while(world.GetUpdate() < stop) {world.Update();}
+}
+
+// every output file of two runs is byte for byte the same
+void RequireSame(const std::string & a, const std::string & b)
+{
+  for(const auto & file : FILES)
+  {
+    INFO(file);
+    const std::string left = Slurp(a + file);
+    REQUIRE(left.size() > 0);
+    REQUIRE(left == Slurp(b + file));
+  }
+}
+
+TEST_CASE("Killed and resumed runs match an uninterrupted run", "[checkpoint]")
+{
+  for(const std::string mode : {"0", "1"})
+  {
+    INFO("RNG_MODE " << mode);
+    const std::string full = "resume-test-full/", killed = "resume-test-killed/";
+    const settings_t settings = {{"RNG_MODE", mode}, {"CHECKPOINT_INTERVAL", "10"}};
+    settings_t resume = settings;
+    resume.emplace_back("CHECKPOINT_RESUME", "1");
+
+    Run(full, settings, MAX_GENS + 1);
+
+    // killed after the checkpoints at 20 and 30, resumed each time
+    Run(killed, settings, 25);
+    Run(killed, resume, 33);
+    Run(killed, resume, MAX_GENS + 1);
+
+    RequireSame(full, killed);
+    REQUIRE(!std::filesystem::exists(killed + "genotype_systematics.csv.resume"));
+
+    std::filesystem::remove_all(full);
+    std::filesystem::remove_all(killed);
+  }
+}
+
+TEST_CASE("Counter based streams do not depend on checkpointing", "[checkpoint]")
+{
+  const std::string plain = "resume-test-plain/", ckpt = "resume-test-ckpt/";
+
+  Run(plain, {{"RNG_MODE", "1"}, {"CHECKPOINT_INTERVAL", "0"}}, MAX_GENS + 1);
+  Run(ckpt, {{"RNG_MODE", "1"}, {"CHECKPOINT_INTERVAL", "10"}}, MAX_GENS + 1);
+
+  RequireSame(plain, ckpt);
+
+  std::filesystem::remove_all(plain);
+  std::filesystem::remove_all(ckpt);
+}
+
+TEST_CASE("Resumed runs keep one timing row per update and phase", "[checkpoint]")
+{
+  const std::string dir = "resume-test-timing/";
+  const settings_t settings = {{"CHECKPOINT_INTERVAL", "10"}, {"TIMING", "1"}};
+  settings_t resume = settings;
+  resume.emplace_back("CHECKPOINT_RESUME", "1");
+
+  Run(dir, settings, 25);
+  Run(dir, resume, 33);
+  Run(dir, resume, MAX_GENS + 1);
+
+  std::istringstream rows(Slurp(dir + "timing.csv"));
+  std::string line;
+  REQUIRE(std::getline(rows, line));
+  REQUIRE(line == "update,phase,calls,seconds,cycles");
+
+  // rows of the killed runs past their checkpoint are gone, updates only move forward
+  std::set<std::string> seen;
+  size_t last = 0;
+  while(std::getline(rows, line))
+  {
+    INFO(line);
+    const std::string key = line.substr(0, line.find(',', line.find(',') + 1));
+    REQUIRE(seen.insert(key).second);
+
+    const size_t update = std::stoul(line);
+    REQUIRE(last <= update);
+    last = update;
+  }
+  REQUIRE(MAX_GENS <= last);
+  REQUIRE(!std::filesystem::exists(dir + "timing.csv.resume"));
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,78 @@
+#define CATCH_CONFIG_MAIN
+
+// testing files
+#include "/mnt/c/Users/josex/Desktop/Research/Repos/Catch/catch.hpp"
+#include "../source/rng.h"
+#include "../source/mutation.h"
+
+// empirical headers
+#include "base/vector.h"
+
+// library includes
+#include <cmath>
+
+// const vars for test
+constexpr uint64_t SEED = 17;
+constexpr size_t M = 100;
+constexpr double TARGET = 100.0;
+constexpr size_t DRAWS = 100000;
+
+// In Tests directory, to run:
+// clang++ -std=c++17 -I ../../../Empirical/source/ rng-test.cpp -o rng-test; ./rng-test
+
+TEST_CASE("Philox known answers", "[philox]")
+{
+  // Random123 known answer vectors for Philox4x32-10
+  REQUIRE(Philox::Block({0, 0, 0, 0}, {0, 0}) == Philox::block_t{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+  REQUIRE(Philox::Block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff})
+          == Philox::block_t{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+  REQUIRE(Philox::Block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0})
+          == Philox::block_t{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("Counter streams replay and differ", "[streams]")
+{
+  CounterRandom a(SEED, 3, 5, RngPurpose::MUTATION), b(SEED, 3, 5, RngPurpose::MUTATION);
+  CounterRandom idx(SEED, 3, 6, RngPurpose::MUTATION), use(SEED, 3, 5, RngPurpose::SELECTION);
+
+  size_t same_idx = 0, same_use = 0;
+  for(size_t i = 0; i < 1000; ++i)
+  {
+    const uint32_t x = a.GetUInt();
+    REQUIRE(x == b.GetUInt());
+    same_idx += x == idx.GetUInt();
+    same_use += x == use.GetUInt();
+  }
+  REQUIRE(same_idx < 2); REQUIRE(same_use < 2);
+
+  // mutation replays exactly from a fresh stream
+  MutationKernel kernel(0.1, 0.0, 1.0, TARGET);
+  emp::vector<double> g1(M, 50.0), g2(M, 50.0);
+  CounterRandom s1(SEED, 7, 11, RngPurpose::MUTATION), s2(SEED, 7, 11, RngPurpose::MUTATION);
+  kernel.Mutate(g1, s1);
+  kernel.Mutate(g2, s2);
+  REQUIRE(g1 == g2);
+}
+
+TEST_CASE("Counter stream distribution", "[distribution]")
+{
+  CounterRandom random(SEED, 0, 0, RngPurpose::SAMPLE);
+
+  double sum = 0.0, sqr = 0.0, nsum = 0.0, nsqr = 0.0;
+  for(size_t i = 0; i < DRAWS; ++i)
+  {
+    const double u = random.GetDouble();
+    REQUIRE(0.0 <= u); REQUIRE(u < 1.0);
+    sum += u; sqr += u * u;
+
+    const double n = random.GetRandNormal();
+    nsum += n; nsqr += n * n;
+  }
+
+  // uniform: mean 1/2, variance 1/12
+  REQUIRE(std::abs(sum / DRAWS - 0.5) < 0.01);
+  REQUIRE(std::abs(sqr / DRAWS - 0.25 - 1.0 / 12.0) < 0.01);
+  // standard normal: mean 0, variance 1
+  REQUIRE(std::abs(nsum / DRAWS) < 0.02);
+  REQUIRE(std::abs(nsqr / DRAWS - 1.0) < 0.02);
+}
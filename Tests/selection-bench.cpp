@@ -0,0 +1,432 @@
+// Micro-benchmarks for the Selection and Diagnostic kernels
+//
+// Every kernel is timed over a grid of population sizes, objective counts and population
+// diversity profiles, and the results are printed as google-benchmark JSON (same "context" and
+// "benchmarks" layout), so runs from different versions can be compared with its tools.
+//
+// In repo root, to build and run:
+// make bench; ./selection-bench --pop=128,512 --obj=10,100 > bench.json
+//
+// Options (lists are comma separated):
+//   --pop=N,...                  population sizes
+//   --obj=M,...                  objective counts
+//   --profile=name,...           diverse, clustered, converged
+//   --benchmark_filter=text      only benchmarks whose name contains text
+//   --benchmark_min_time=secs    time each benchmark for at least this long
+//   --benchmark_out=path         write the JSON here instead of stdout
+
+// experiment headers
+#include "../source/problem.h"
+#include "../source/selection.h"
+
+// empirical headers
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+#include "emp/math/random_utils.hpp"
+
+// library includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// const vars for the benchmarks (experiment defaults where they fit every size)
+constexpr size_t SEED = 17;
+constexpr double TARGET = 100.0;
+constexpr double CREDIT = 0.0;
+constexpr double ACCURACY = 0.99;
+constexpr size_t TOUR_SIZE = 8;
+constexpr size_t NOVEL_K = 15;
+constexpr double LEX_EPS = 1.0;
+constexpr double DSLEX_PROP = 0.5;
+constexpr double PNORM_EXP = 2.0;
+constexpr double FIT_ALPHA = 1.0;
+constexpr double FIT_SIGMA = 0.1;
+// clusters in the clustered profile, share of mutants in the converged one
+constexpr size_t CLUSTERS = 8;
+constexpr double MUTANTS = 0.1;
+
+using ids_t = Selection::ids_t;
+using score_t = Selection::score_t;
+using fmatrix_t = Selection::fmatrix_t;
+using kernel_t = std::function<void()>;
+
+// results land here so the compiler cannot drop the work
+volatile double sink = 0.0;
+
+struct BenchResult
+{
+  std::string name;
+  std::string label;
+  size_t iterations;
+  // per iteration
+  double real_ns;
+  double cpu_ns;
+};
+
+// split "a,b,c"
+emp::vector<std::string> Split(const std::string & s)
+{
+  emp::vector<std::string> parts;
+  std::stringstream in(s);
+  std::string part;
+  while(std::getline(in, part, ',')) {if(!part.empty()) {parts.push_back(part);}}
+  return parts;
+}
+
+/**
+ * Population function:
+ *
+ * N genomes of M genes in [0, TARGET], with one of three diversity profiles:
+ * diverse (every gene uniform), clustered (CLUSTERS centers plus small noise)
+ * and converged (clones of one genome, MUTANTS of them with one gene changed).
+ *
+ * @param rng random number generator.
+ * @param N population size.
+ * @param M objective count.
+ * @param profile diversity profile.
+ *
+ * @return population genomes.
+ */
+fmatrix_t Population(emp::Random & rng, const size_t N, const size_t M, const std::string & profile)
+{
+  auto clip = [](const double g) {return std::min(std::max(g, 0.0), TARGET);};
+  fmatrix_t pop(N, score_t(M));
+
+  if(profile == "clustered")
+  {
+    fmatrix_t centers(CLUSTERS, score_t(M));
+    for(auto & c : centers) {for(auto & g : c) {g = rng.GetDouble(0.0, TARGET);}}
+    for(size_t i = 0; i < N; ++i)
+    {
+      const score_t & c = centers[i % CLUSTERS];
+      for(size_t j = 0; j < M; ++j) {pop[i][j] = clip(c[j] + rng.GetRandNormal(0.0, 1.0));}
+    }
+  }
+  else if(profile == "converged")
+  {
+    score_t base(M);
+    for(auto & g : base) {g = rng.GetDouble(0.0, TARGET);}
+    for(size_t i = 0; i < N; ++i)
+    {
+      pop[i] = base;
+      if(rng.P(MUTANTS)) {const size_t j = rng.GetUInt(M); pop[i][j] = clip(pop[i][j] + rng.GetRandNormal(0.0, 1.0));}
+    }
+  }
+  else
+  {
+    for(auto & org : pop) {for(auto & g : org) {g = rng.GetDouble(0.0, TARGET);}}
+  }
+
+  return pop;
+}
+
+/**
+ * Run function:
+ *
+ * Like google-benchmark: the iteration count grows until one batch runs for min_time,
+ * and that batch is reported.
+ *
+ * @param body one iteration.
+ * @param min_time seconds the reported batch must run for.
+ *
+ * @return timing of the final batch (name & label left for the caller).
+ */
+BenchResult Run(const kernel_t & body, const double min_time)
+{
+  // warm caches & allocators
+  body();
+
+  size_t iters = 1;
+  while(true)
+  {
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::clock_t c0 = std::clock();
+    for(size_t i = 0; i < iters; ++i) {body();}
+    const double cpu = static_cast<double>(std::clock() - c0) / CLOCKS_PER_SEC;
+    const double real = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if(real >= min_time || iters >= 1000000000)
+    {
+      return {"", "", iters, real * 1e9 / iters, cpu * 1e9 / iters};
+    }
+
+    // aim a bit past min_time, by at most 10x per step
+    const double mult = (real / min_time > 0.1) ? min_time * 1.4 / real : 10.0;
+    iters = std::max(iters + 1, static_cast<size_t>(iters * std::min(mult, 10.0)));
+  }
+}
+
+// fixed size diagnostic kernels (only built for the objective counts the world specializes)
+template <size_t M>
+void AddFixed(emp::vector<std::pair<std::string, kernel_t>> & kernels, const fmatrix_t & genomes)
+{
+  using fixed_t = FixedDiagnostic<M>;
+  const std::pair<const char *, typename fixed_t::kernel_t> fixed[] =
+  {
+    {"FixedExploitation", &fixed_t::Exploitation}, {"FixedStructExploitation", &fixed_t::StructExploitation},
+    {"FixedStrongEcology", &fixed_t::StrongEcology}, {"FixedExploration", &fixed_t::Exploration},
+    {"FixedWeakEcology", &fixed_t::WeakEcology}
+  };
+
+  for(const auto & f : fixed)
+  {
+    const auto kernel = f.second;
+    kernels.emplace_back(f.first, [&genomes, kernel]()
+    {
+      const fixed_t diag(TARGET, CREDIT);
+      typename fixed_t::score_t score;
+      for(const auto & g : genomes) {(diag.*kernel)(g.data(), score); sink = sink + score[0];}
+    });
+  }
+
+  kernels.emplace_back("FixedOptimizedVector", [&genomes]()
+  {
+    const fixed_t diag(TARGET, CREDIT);
+    typename fixed_t::opti_t opti;
+    for(const auto & g : genomes) {sink = sink + diag.OptimizedVector(g.data(), ACCURACY, opti);}
+  });
+}
+
+/**
+ * Kernels function:
+ *
+ * One iteration of a selection kernel picks a full generation of N parents (or builds what the
+ * world builds once per generation); one iteration of a diagnostic scores the whole population.
+ * Scores are the genomes themselves (exploitation diagnostic), aggregates are their sums.
+ *
+ * @param sel selector (owns the random stream).
+ * @param rng random number generator shared with sel.
+ * @param genomes population genomes.
+ * @param agg aggregate score per organism.
+ *
+ * @return (name, iteration) pairs.
+ */
+emp::vector<std::pair<std::string, kernel_t>> Kernels(Selection & sel, emp::Random & rng, const fmatrix_t & genomes, const score_t & agg)
+{
+  const size_t N = genomes.size(), M = genomes[0].size();
+  const size_t K = std::min(NOVEL_K, N - 1);
+  // mu must divide the population, cohorts must split both dimensions evenly
+  const size_t mu = (N % 8 == 0) ? N / 8 : 1;
+  const double coh_prop = (N % 2 == 0 && M % 2 == 0) ? 0.5 : 1.0;
+  const double sigma = sel.Pnorm(score_t(M, TARGET), score_t(M, 0.0), PNORM_EXP) * FIT_SIGMA;
+
+  emp::vector<std::pair<std::string, kernel_t>> kernels;
+
+  ///< selection kernels
+
+  kernels.emplace_back("Tournament", [&sel, &agg, N]()
+  {
+    for(size_t i = 0; i < N; ++i) {sink = sink + sel.Tournament(TOUR_SIZE, agg);}
+  });
+
+  kernels.emplace_back("TournamentBatch", [&sel, &agg, N]()
+  {
+    sink = sink + sel.TournamentBatch(N, TOUR_SIZE, agg)[0];
+  });
+
+  kernels.emplace_back("MLSelect", [&sel, &agg, N, mu]()
+  {
+    const Selection::fitgp_t group = sel.FitnessGroup(agg);
+    sink = sink + sel.MLSelect(mu, N, group)[0];
+  });
+
+  kernels.emplace_back("FitnessSharing", [&sel, &genomes, &agg, sigma]()
+  {
+    const fmatrix_t dmat = sel.SimilarityMatrix(genomes, PNORM_EXP);
+    sink = sink + sel.FitnessSharing(dmat, agg, FIT_ALPHA, sigma)[0];
+  });
+
+  kernels.emplace_back("Novelty", [&sel, &agg, K]()
+  {
+    const Selection::neigh_t neigh = sel.FitNearestN(agg, K);
+    sink = sink + sel.Novelty(agg, neigh, K)[0];
+  });
+
+  kernels.emplace_back("LexicaseNoveltyFit", [&sel, &genomes, K, M]()
+  {
+    sink = sink + sel.LexicaseNoveltyFit(genomes, K, M)[0][0];
+  });
+
+  kernels.emplace_back("EpsiLexicase", [&sel, &genomes, N, M]()
+  {
+    for(size_t i = 0; i < N; ++i) {sink = sink + sel.EpsiLexicase(genomes, LEX_EPS, M);}
+  });
+
+  kernels.emplace_back("LexReduce", [&sel, &genomes, N, M]()
+  {
+    const Selection::LexPool pool = sel.LexReduce(genomes, LEX_EPS, M);
+    for(size_t i = 0; i < N; ++i) {sink = sink + sel.EpsiLexicase(pool, LEX_EPS);}
+  });
+
+  kernels.emplace_back("DSELexicase", [&sel, &rng, &genomes, N, M]()
+  {
+    const ids_t cases = emp::Choose(rng, M, std::max<size_t>(1, M * DSLEX_PROP));
+    const score_t dmat = sel.DownSample(genomes, cases);
+    for(size_t i = 0; i < N; ++i) {sink = sink + sel.DSELexicase(dmat, N, LEX_EPS);}
+  });
+
+  kernels.emplace_back("CELexicase", [&sel, &genomes, N, M, coh_prop]()
+  {
+    const Selection::cohort_t pop_coh = sel.CohortGeneration(N, coh_prop);
+    const Selection::cohort_t test_coh = sel.CohortGeneration(M, coh_prop);
+    for(size_t p = 0; p < pop_coh.size(); ++p)
+    {
+      for(size_t c = 0; c < pop_coh[p].size(); ++c) {sink = sink + sel.CELexicase(genomes, LEX_EPS, pop_coh[p], test_coh[p]);}
+    }
+  });
+
+  ///< diagnostic kernels
+
+  using diag_fun_t = Diagnostic::score_t (Diagnostic::*)(const Diagnostic::genome_t &);
+  const std::pair<const char *, diag_fun_t> diags[] =
+  {
+    {"Exploitation", &Diagnostic::Exploitation}, {"StructExploitation", &Diagnostic::StructExploitation},
+    {"StrongEcology", &Diagnostic::StrongEcology}, {"Exploration", &Diagnostic::Exploration},
+    {"WeakEcology", &Diagnostic::WeakEcology}
+  };
+
+  for(const auto & d : diags)
+  {
+    const diag_fun_t fun = d.second;
+    kernels.emplace_back(d.first, [&genomes, fun, M]()
+    {
+      Diagnostic::target_t target(M, TARGET);
+      Diagnostic diag(target, CREDIT);
+      for(const auto & g : genomes) {sink = sink + (diag.*fun)(g)[0];}
+    });
+  }
+
+  kernels.emplace_back("OptimizedVector", [&genomes, M]()
+  {
+    Diagnostic::target_t target(M, TARGET);
+    Diagnostic diag(target, CREDIT);
+    for(const auto & g : genomes) {sink = sink + diag.OptimizedVector(g, ACCURACY)[0];}
+  });
+
+  switch(M)
+  {
+    case 10: AddFixed<10>(kernels, genomes); break;
+    case 50: AddFixed<50>(kernels, genomes); break;
+    case 100: AddFixed<100>(kernels, genomes); break;
+    case 1000: AddFixed<1000>(kernels, genomes); break;
+    default: break;
+  }
+
+  return kernels;
+}
+
+// google-benchmark JSON
+void WriteJson(std::ostream & out, const std::string & exe, const emp::vector<BenchResult> & results)
+{
+  const std::time_t now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+  out << "{\n";
+  out << "  \"context\": {\n";
+  out << "    \"date\": \"" << date << "\",\n";
+  out << "    \"executable\": \"" << exe << "\",\n";
+  out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+  out << "    \"library_build_type\": \"release\"\n";
+#else
+  out << "    \"library_build_type\": \"debug\"\n";
+#endif
+  out << "  },\n";
+  out << "  \"benchmarks\": [\n";
+  for(size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchResult & r = results[i];
+    out << "    {\n";
+    out << "      \"name\": \"" << r.name << "\",\n";
+    out << "      \"run_name\": \"" << r.name << "\",\n";
+    out << "      \"run_type\": \"iteration\",\n";
+    out << "      \"iterations\": " << r.iterations << ",\n";
+    out << "      \"real_time\": " << r.real_ns << ",\n";
+    out << "      \"cpu_time\": " << r.cpu_ns << ",\n";
+    out << "      \"time_unit\": \"ns\",\n";
+    out << "      \"label\": \"" << r.label << "\"\n";
+    out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n";
+  out << "}\n";
+}
+
+int main(int argc, char * argv[])
+{
+  emp::vector<size_t> pops = {128, 512};
+  emp::vector<size_t> objs = {10, 100};
+  emp::vector<std::string> profiles = {"diverse", "clustered", "converged"};
+  std::string filter = "", out_path = "";
+  double min_time = 0.5;
+
+  for(int a = 1; a < argc; ++a)
+  {
+    const std::string arg = argv[a];
+    const size_t eq = arg.find('=');
+    const std::string key = arg.substr(0, eq), val = (eq == std::string::npos) ? "" : arg.substr(eq + 1);
+
+    if(key == "--pop") {pops.clear(); for(const auto & p : Split(val)) {pops.push_back(std::stoul(p));}}
+    else if(key == "--obj") {objs.clear(); for(const auto & o : Split(val)) {objs.push_back(std::stoul(o));}}
+    else if(key == "--profile") {profiles = Split(val);}
+    else if(key == "--benchmark_filter") {filter = val;}
+    else if(key == "--benchmark_min_time") {min_time = std::stod(val);}
+    else if(key == "--benchmark_out") {out_path = val;}
+    else {std::cerr << "UNKNOWN OPTION " << arg << std::endl; return 1;}
+  }
+
+  for(const auto & p : profiles)
+  {
+    if(p != "diverse" && p != "clustered" && p != "converged") {std::cerr << "UNKNOWN PROFILE " << p << std::endl; return 1;}
+  }
+  for(const size_t N : pops) {if(N < 2) {std::cerr << "POPULATION SIZE MUST BE AT LEAST 2" << std::endl; return 1;}}
+  for(const size_t M : objs) {if(M < 1) {std::cerr << "OBJECTIVE COUNT MUST BE AT LEAST 1" << std::endl; return 1;}}
+
+  emp::vector<BenchResult> results;
+
+  for(const size_t N : pops)
+  {
+    for(const size_t M : objs)
+    {
+      for(const auto & profile : profiles)
+      {
+        // same seed for every grid point, so versions see identical populations and draws
+        emp::Ptr<emp::Random> rng = emp::NewPtr<emp::Random>(SEED);
+        Selection sel(rng);
+
+        const fmatrix_t genomes = Population(*rng, N, M, profile);
+        score_t agg(N);
+        for(size_t i = 0; i < N; ++i) {agg[i] = std::accumulate(genomes[i].begin(), genomes[i].end(), 0.0);}
+
+        for(const auto & k : Kernels(sel, *rng, genomes, agg))
+        {
+          const std::string name = k.first + "/pop:" + std::to_string(N) + "/obj:" + std::to_string(M) + "/profile:" + profile;
+          if(!filter.empty() && name.find(filter) == std::string::npos) {continue;}
+
+          BenchResult r = Run(k.second, min_time);
+          r.name = name; r.label = profile;
+          std::cerr << name << ": " << r.real_ns / 1e3 << " us (" << r.iterations << " iterations)" << std::endl;
+          results.push_back(r);
+        }
+
+        rng.Delete();
+      }
+    }
+  }
+
+  if(out_path.empty()) {WriteJson(std::cout, argv[0], results); return 0;}
+
+  std::ofstream out(out_path);
+  if(!out) {std::cerr << "UNABLE TO OPEN " << out_path << std::endl; return 1;}
+  WriteJson(out, argv[0], results);
+  return 0;
+}
@@ -662,6 +662,41 @@ TEST_CASE("Tournmanent selector function", "[tournament]")
   random.Delete();
 }
 
+TEST_CASE("Batched tournament selector function", "[tournament]")
+{
+  // same seed for the selector and the reference draws
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  emp::Random check(SEED);
+  Selection select(random);
+  const size_t pop = 100;
+  emp::vector<double> scores(pop);
+  for(size_t i = 0; i < pop; ++i) {scores[i] = static_cast<double>(i % 10);}
+
+  // identical to drawing t entrants with replacement per tournament, first drawn wins ties
+  for(size_t t : {1, 2, 7, 50, 300})
+  {
+    const emp::vector<size_t> output = select.TournamentBatch(pop, t, scores);
+    REQUIRE(output.size() == pop);
+
+    for(size_t T = 0; T < pop; ++T)
+    {
+      size_t best = check.GetUInt(pop);
+      for(size_t i = 1; i < t; ++i)
+      {
+        const size_t cur = check.GetUInt(pop);
+        if(scores[cur] > scores[best]) {best = cur;}
+      }
+      REQUIRE(output[T] == best);
+    }
+  }
+
+  // a single best solution wins every large tournament it enters
+  std::iota(scores.begin(), scores.end(), 0.0);
+  for(size_t winner : select.TournamentBatch(pop, 1000, scores)) {REQUIRE(winner == pop - 1);}
+
+  random.Delete();
+}
+
 TEST_CASE ("Epsilon lexicase selector function", "[lexicase]")
 {
   // all the vars we will be altering
@@ -764,4 +799,187 @@ TEST_CASE ("Epsilon lexicase selector function", "[lexicase]")
 
 
   random.Delete();
-}
\ No newline at end of file
+}
+
+TEST_CASE("Dense down sampled lexicase selector function", "[lexicase]")
+{
+  // two selectors on the same random stream
+  emp::Ptr<emp::Random> r_full = emp::NewPtr<emp::Random>(SEED);
+  emp::Ptr<emp::Random> r_dense = emp::NewPtr<emp::Random>(SEED);
+  Selection full(r_full), dense(r_dense);
+  const size_t N = 60, M = 30;
+
+  // coarse scores so ties and epsilon groups happen
+  emp::Random fill(SEED + 1);
+  emp::vector<emp::vector<double>> mscore(N, emp::vector<double>(M));
+  for(auto & row : mscore) {for(auto & s : row) {s = static_cast<double>(fill.GetUInt(5));}}
+  const emp::vector<size_t> t_cases = {3, 17, 0, 29, 8, 12};
+
+  // column k holds everyone's score on t_cases[k]
+  const emp::vector<double> dmat = dense.DownSample(mscore, t_cases);
+  REQUIRE(dmat.size() == N * t_cases.size());
+  for(size_t k = 0; k < t_cases.size(); ++k)
+  {
+    for(size_t i = 0; i < N; ++i) {REQUIRE(dmat[k * N + i] == mscore[i][t_cases[k]]);}
+  }
+
+  // same winners, event by event
+  for(double epsi : {0.0, 1.0})
+  {
+    for(size_t i = 0; i < EL_RUNS / 10; ++i)
+    {
+      REQUIRE(full.DSELexicase(mscore, epsi, t_cases) == dense.DSELexicase(dmat, N, epsi));
+    }
+  }
+
+  r_full.Delete();
+  r_dense.Delete();
+}
+
+TEST_CASE("Dense lexicase selector function", "[lexicase]")
+{
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  Selection select(random);
+  const size_t N = 8, S = 5;
+
+  // column-major: row 6 is best on every testcase
+  emp::vector<double> dmat(N * S, 0.0);
+  for(size_t k = 0; k < S; ++k) {for(size_t i = 0; i < N; ++i) {dmat[k * N + i] = static_cast<double>((i * 3 + k) % 5);} dmat[k * N + 6] = 10.0;}
+  emp::Random a(SEED);
+  for(size_t i = 0; i < EL_RUNS / 10; ++i) {REQUIRE(select.DenseLexicase(dmat.data(), N, S, 0.0, a) == 6);}
+
+  // row 2 best on testcase 0 only, row 5 best on the rest: both win, nothing else does
+  std::fill(dmat.begin(), dmat.end(), 0.0);
+  dmat[0 * N + 2] = 1.0;
+  for(size_t k = 1; k < S; ++k) {dmat[k * N + 5] = 1.0;}
+  std::set<size_t> winners;
+  for(size_t i = 0; i < EL_RUNS / 10; ++i) {winners.insert(select.DenseLexicase(dmat.data(), N, S, 0.0, a));}
+  REQUIRE(winners == std::set<size_t>{2, 5});
+
+  // epsilon lets everyone within reach survive, ties broken at random
+  winners.clear();
+  for(size_t i = 0; i < EL_RUNS / 10; ++i) {winners.insert(select.DenseLexicase(dmat.data(), N, S, 1.0, a));}
+  REQUIRE(winners.size() == N);
+
+  // only the stream passed in is used: same seed, same winners, shared generator untouched
+  emp::Random c(SEED + 5), d(SEED + 5);
+  const double before = emp::Random(SEED).GetDouble();
+  for(size_t i = 0; i < EL_RUNS / 10; ++i) {REQUIRE(select.DenseLexicase(dmat.data(), N, S, 0.0, c) == select.DenseLexicase(dmat.data(), N, S, 0.0, d));}
+  REQUIRE(random->GetDouble() == before);
+
+  random.Delete();
+}
+
+TEST_CASE("Lexicase reduction function", "[lexicase]")
+{
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  Selection select(random);
+  const size_t M = 3;
+
+  // 0,3,5 identical; 1 dominated by 2; 4 within epsilon 1 of 2 on its only gap
+  const emp::vector<emp::vector<double>> mscore = {{5,1,1}, {1,1,1}, {2,5,2}, {5,1,1}, {2,4.5,2}, {5,1,1}, {1,2,6}};
+
+  // epsilon 0: duplicates merged, 1 & 4 dropped
+  Selection::LexPool pool = select.LexReduce(mscore, 0.0, M);
+  REQUIRE(pool.Size() == 3);
+  REQUIRE(pool.members.size() == 5);
+  std::set<size_t> kept(pool.members.begin(), pool.members.end());
+  REQUIRE(kept == std::set<size_t>{0, 2, 3, 5, 6});
+
+  // epsilon 1: row 4 can tie with row 2, so it stays
+  pool = select.LexReduce(mscore, 1.0, M);
+  kept = std::set<size_t>(pool.members.begin(), pool.members.end());
+  REQUIRE(kept == std::set<size_t>{0, 2, 3, 4, 5, 6});
+
+  // same parent distribution as lexicase on the full matrix
+  for(double epsi : {0.0, 1.0})
+  {
+    pool = select.LexReduce(mscore, epsi, M);
+    emp::vector<double> full(mscore.size(), 0.0), reduced(mscore.size(), 0.0);
+    for(size_t i = 0; i < EL_RUNS * 5; ++i)
+    {
+      full[select.EpsiLexicase(mscore, epsi, M)] += 1.0;
+      reduced[select.EpsiLexicase(pool, epsi)] += 1.0;
+    }
+    for(size_t i = 0; i < mscore.size(); ++i)
+    {
+      REQUIRE(std::abs(full[i] - reduced[i]) / (EL_RUNS * 5) < 0.01);
+      if(!kept.count(i) || (epsi == 0.0 && i == 4)) {REQUIRE(reduced[i] == 0.0);}
+    }
+  }
+
+  random.Delete();
+}
+
+TEST_CASE("Deduplicated lexicase selector function", "[lexicase]")
+{
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  Selection select(random);
+  const size_t N = 40, M = 4;
+
+  // few distinct phenotypes, uneven multiplicities
+  const emp::vector<emp::vector<double>> phen = {{3,0,1,2}, {0,3,2,1}, {1,1,1,1}, {3,0,1,2.5}};
+  emp::vector<emp::vector<double>> mscore;
+  for(size_t i = 0; i < N; ++i) {mscore.push_back(phen[(i % 7) % phen.size()]);}
+
+  // every solution kept, one row per phenotype, multiplicities add up
+  const Selection::LexPool pool = select.LexReduce(mscore, 0.0, M, false);
+  std::set<emp::vector<double>> distinct(mscore.begin(), mscore.end());
+  REQUIRE(pool.Size() == distinct.size());
+  REQUIRE(pool.members.size() == N);
+  for(size_t u = 0; u < pool.Size(); ++u)
+  {
+    for(size_t j = pool.start[u]; j < pool.start[u + 1]; ++j) {for(size_t t = 0; t < M; ++t) {REQUIRE(mscore[pool.members[j]][t] == pool.Score(u, t));}}
+  }
+
+  // same parent distribution as lexicase on the full matrix
+  emp::vector<double> full(N, 0.0), dedup(N, 0.0);
+  for(size_t i = 0; i < EL_RUNS * 5; ++i)
+  {
+    full[select.EpsiLexicase(mscore, 0.0, M)] += 1.0;
+    dedup[select.EpsiLexicase(pool, 0.0)] += 1.0;
+  }
+  for(size_t i = 0; i < N; ++i) {REQUIRE(std::abs(full[i] - dedup[i]) / (EL_RUNS * 5) < 0.01);}
+
+  random.Delete();
+}
+TEST_CASE("Counter stream selection events", "[rng]")
+{
+  emp::Ptr<emp::Random> random = emp::NewPtr<emp::Random>(SEED);
+  Selection select(random);
+  select.SetCounterStreams(SEED);
+  const size_t N = 60, M = 5, EVENTS = 40;
+
+  // coarse scores, so lexicase ties are broken at random
+  emp::vector<emp::vector<double>> mscore(N, emp::vector<double>(M));
+  for(auto & row : mscore) {for(auto & s : row) {s = static_cast<double>(random->GetUInt(3));}}
+  const emp::vector<double> agg(N, 1.0);
+
+  select.SetEvent(7);
+  emp::vector<size_t> lex, tour;
+  for(size_t i = 0; i < EVENTS; ++i) {lex.push_back(select.EpsiLexicase(mscore, 0.0, M));}
+  for(size_t i = 0; i < EVENTS; ++i) {tour.push_back(select.Tournament(4, agg));}
+
+  // draws on the shared generator change nothing
+  for(size_t i = 0; i < 100; ++i) {random->GetUInt();}
+
+  // any single event replays on its own, in any order
+  for(size_t i = EVENTS; i-- > 0;)
+  {
+    select.SetEvent(7, i);
+    REQUIRE(select.EpsiLexicase(mscore, 0.0, M) == lex[i]);
+    select.SetEvent(7, EVENTS + i);
+    REQUIRE(select.Tournament(4, agg) == tour[i]);
+  }
+
+  // another generation draws differently
+  select.SetEvent(8);
+  emp::vector<size_t> next;
+  for(size_t i = 0; i < EVENTS; ++i) {next.push_back(select.EpsiLexicase(mscore, 0.0, M));}
+  REQUIRE(next != lex);
+
+  // winners are still spread over the tied solutions
+  REQUIRE(std::set<size_t>(lex.begin(), lex.end()).size() > 1);
+
+  random.Delete();
+}
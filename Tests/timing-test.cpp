@@ -0,0 +1,108 @@
+#define CATCH_CONFIG_MAIN
+
+// testing files
+#include "/mnt/c/Users/josex/Desktop/Research/Repos/Catch/catch.hpp"
+#include "../source/timing.h"
+
+// library includes
+#include <sstream>
+#include <string>
+#include <thread>
+
+// In Tests directory, to run:
+// clang++ -std=c++17 -I ../../../Empirical/source/ timing-test.cpp -o timing-test; ./timing-test
+
+// count lines in a string
+size_t Lines(const std::string & s)
+{
+  size_t n = 0;
+  for(const char c : s) {n += c == '\n';}
+  return n;
+}
+
+TEST_CASE("Timer off records nothing", "[timing]")
+{
+  PhaseTimer timer;
+  REQUIRE(!timer.IsOn());
+
+  {ScopedPhase p(timer, Phase::SELECTION);}
+  REQUIRE(timer.GetTotal(Phase::SELECTION).calls == 0);
+
+  std::ostringstream rows;
+  timer.WriteRows(rows, 10);
+  REQUIRE(rows.str().empty());
+}
+
+TEST_CASE("Phases accumulate calls and time", "[timing]")
+{
+  PhaseTimer timer;
+  timer.SetMode(1);
+  REQUIRE(timer.IsOn());
+
+  for(size_t i = 0; i < 3; ++i)
+  {
+    ScopedPhase outer(timer, Phase::SELECTION);
+    {
+      ScopedPhase inner(timer, Phase::POP_FIT_MAT);
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+
+  const PhaseTimer::Slot sel = timer.GetTotal(Phase::SELECTION);
+  const PhaseTimer::Slot mat = timer.GetTotal(Phase::POP_FIT_MAT);
+  REQUIRE(sel.calls == 3);
+  REQUIRE(mat.calls == 3);
+  // nested phase inside its parent
+  REQUIRE(mat.ns >= 6000000);
+  REQUIRE(sel.ns >= mat.ns);
+  REQUIRE(timer.GetTotal(Phase::RESET).calls == 0);
+}
+
+TEST_CASE("Rows cover the interval since the last row", "[timing]")
+{
+  PhaseTimer timer;
+  timer.SetMode(1);
+
+  std::ostringstream rows;
+  timer.WriteHeader(rows);
+  REQUIRE(rows.str() == "update,phase,calls,seconds,cycles\n");
+
+  {ScopedPhase p(timer, Phase::RESET);}
+  {ScopedPhase p(timer, Phase::EVALUATION);}
+  timer.WriteRows(rows, 0);
+  // header + one row per phase that ran
+  REQUIRE(Lines(rows.str()) == 3);
+  REQUIRE(rows.str().find("\n0,reset,1,") != std::string::npos);
+  REQUIRE(rows.str().find("\n0,evaluation,1,") != std::string::npos);
+
+  // nothing ran since the last row
+  timer.WriteRows(rows, 1);
+  REQUIRE(Lines(rows.str()) == 3);
+
+  // totals keep the written rows
+  {ScopedPhase p(timer, Phase::RESET);}
+  timer.WriteRows(rows, 2);
+  REQUIRE(Lines(rows.str()) == 4);
+  REQUIRE(rows.str().find("\n2,reset,1,") != std::string::npos);
+  REQUIRE(timer.GetTotal(Phase::RESET).calls == 2);
+  REQUIRE(timer.GetTotal(Phase::EVALUATION).calls == 1);
+}
+
+TEST_CASE("Summary lists every phase that ran", "[timing]")
+{
+  PhaseTimer timer;
+  timer.SetMode(2);
+
+  std::ostringstream empty;
+  timer.Summary(empty);
+  REQUIRE(empty.str().empty());
+
+  {ScopedPhase p(timer, Phase::REPRODUCTION); std::this_thread::sleep_for(std::chrono::milliseconds(1));}
+  {ScopedPhase p(timer, Phase::SNAPSHOT);}
+
+  std::ostringstream out;
+  timer.Summary(out);
+  REQUIRE(out.str().find("reproduction") != std::string::npos);
+  REQUIRE(out.str().find("snapshot") != std::string::npos);
+  REQUIRE(out.str().find("selection") == std::string::npos);
+}
@@ -0,0 +1,339 @@
+/// Organism storage that recycles dead organisms so steady state generations never touch the heap
+
+#ifndef DIA_ARENA_H
+#define DIA_ARENA_H
+
+///< standard headers
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+///< experiment headers
+#include "precision.h"
+
+class OrgArena
+{
+  // object types for consistency between working class
+  public:
+    // genome & score buffers (gene_t, see precision.h)
+    using dvec_t = emp::vector<gene_t>;
+    // optimal gene buffers
+    using bvec_t = emp::vector<bool>;
+    // mutated gene position buffers
+    using ivec_t = emp::vector<size_t>;
+
+    // where organisms are placed
+    enum class Mode {HEAP, BUFFERS, POOL};
+
+    // allocation counters (since the arena was reserved)
+    struct Stats
+    {
+      // organisms allocated
+      size_t allocs = 0;
+      // organisms freed
+      size_t frees = 0;
+      // organisms placed in recycled storage
+      size_t reused = 0;
+      // organisms (or pool growth) that went to the heap
+      size_t heap = 0;
+      // vectors given a recycled buffer
+      size_t vec_reused = 0;
+      // vectors that had to allocate their own buffer (or grow a recycled one)
+      size_t vec_heap = 0;
+    };
+
+  public:
+
+    // arena used by organisms created on this thread
+    static OrgArena & Local() {static thread_local OrgArena arena; return arena;}
+
+    ~OrgArena() {Release();}
+
+    /**
+     * Reserve function:
+     *
+     * Preallocates two buffers of slots organisms each.
+     * Births are placed in the back buffer, the front buffer holds the current generation.
+     *
+     * @param slots organisms per generation.
+     * @param bytes size of one organism.
+     */
+    void Reserve(const size_t slots, const size_t bytes);
+
+    /**
+     * Reserve Pool function:
+     *
+     * Preallocates slots organisms and their vector buffers (M genes each).
+     * Dead organisms go on a free list that the next birth takes from, in any order.
+     * The pool grows by slots organisms whenever the free list runs dry.
+     *
+     * @param slots organisms to preallocate.
+     * @param bytes size of one organism.
+     * @param M genes per organism.
+     */
+    void ReservePool(const size_t slots, const size_t bytes, const size_t M);
+
+    // hand the storage back to the heap (kept if organisms still live in it)
+    void Release();
+
+    // are organisms coming from the arena?
+    bool IsActive() const {return mode != Mode::HEAP;}
+
+    // storage for a new organism
+    void * Allocate(const size_t bytes);
+
+    // return storage of a dead organism
+    void Free(void * p);
+
+    /**
+     * Swap function:
+     *
+     * Called once per generation after the previous generation has died (double buffered mode).
+     * The emptied front buffer becomes the back buffer the next births are written into.
+     *
+     * @return false (and nothing changes) if organisms still live in the front buffer.
+     */
+    bool Swap();
+
+    ///< internal vector recycling
+
+    // give v a recycled buffer if one is spare
+    template <typename V>
+    void Take(V & v)
+    {
+      if(!IsActive()) {return;}
+      auto & spare = Spares(v);
+      if(spare.size() == 0) {++stats.vec_heap; return;}
+      v.swap(spare.back());
+      spare.pop_back();
+      v.clear();
+      ++stats.vec_reused;
+    }
+
+    // keep the buffer of v for the next organism
+    template <typename V>
+    void Give(V & v)
+    {
+      auto & spare = Spares(v);
+      if(!IsActive() || v.capacity() == 0 || spare_cap <= spare.size()) {return;}
+      spare.push_back(std::move(v));
+    }
+
+    // make room for n elements in v, counting the allocation if its recycled buffer is too small
+    // (a vector Take found no buffer for was counted there)
+    template <typename V>
+    void Fit(V & v, const size_t n)
+    {
+      if(n <= v.capacity()) {return;}
+      if(IsActive() && v.capacity()) {++stats.vec_heap;}
+      v.reserve(n);
+    }
+
+    ///< statistics
+
+    const Stats & GetStats() const {return stats;}
+
+    // organisms that did not fit and went to the heap
+    size_t GetHeapCnt() const {return stats.heap;}
+
+    // organisms currently alive in arena storage
+    size_t GetLive() const {return live[0] + live[1];}
+
+    // organism slots owned by the arena
+    size_t GetCapacity() const {return chunks.size() * slots;}
+
+  private:
+    // which buffer or pool chunk holds p (npos if none)
+    size_t Which(const void * p) const
+    {
+      for(size_t c = 0; c < chunks.size(); ++c)
+      {
+        if(chunks[c] <= p && p < chunks[c] + slots * stride) {return c;}
+      }
+      return npos;
+    }
+
+    // add one more chunk of free slots to the pool
+    void Grow();
+
+    // round organism size up so every slot stays aligned (and can hold a free list link)
+    void SetStride(const size_t bytes)
+    {
+      const size_t align = alignof(std::max_align_t);
+      stride = (std::max(bytes, sizeof(void *)) + align - 1) / align * align;
+    }
+
+    emp::vector<dvec_t> & Spares(dvec_t &) {return spare_d;}
+    emp::vector<bvec_t> & Spares(bvec_t &) {return spare_b;}
+    emp::vector<ivec_t> & Spares(ivec_t &) {return spare_i;}
+
+  private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // current placement
+    Mode mode = Mode::HEAP;
+
+    // generation buffers (double buffered) or pool chunks (pool)
+    emp::vector<char *> chunks;
+    // slots handed out from each buffer since it became the back buffer (double buffered)
+    size_t used[2] = {0, 0};
+    // organisms alive in each buffer (double buffered) or in the pool (live[0], pool)
+    size_t live[2] = {0, 0};
+    // buffer births go into (double buffered)
+    size_t back = 0;
+    // first free slot, each free slot stores the next one (pool)
+    void * free_list = nullptr;
+
+    // slots per buffer / chunk
+    size_t slots = 0;
+    // bytes per slot
+    size_t stride = 0;
+
+    // recycled vector buffers
+    emp::vector<dvec_t> spare_d;
+    emp::vector<bvec_t> spare_b;
+    emp::vector<ivec_t> spare_i;
+    // max spare buffers of each kind
+    size_t spare_cap = 0;
+
+    // allocation counters
+    Stats stats;
+};
+
+void OrgArena::Reserve(const size_t slots_, const size_t bytes)
+{
+  emp_assert(0 < slots_); emp_assert(0 < bytes);
+
+  // storage left behind by an earlier world on this thread
+  Release();
+  emp_assert(!IsActive());
+
+  SetStride(bytes);
+  slots = slots_;
+  for(size_t b = 0; b < 2; ++b) {chunks.push_back(static_cast<char *>(::operator new(slots * stride)));}
+  used[0] = used[1] = 0; live[0] = live[1] = 0;
+  back = 0;
+  mode = Mode::BUFFERS;
+  stats = Stats();
+
+  // genome + score per organism, two generations
+  spare_cap = 4 * slots;
+  spare_d.reserve(spare_cap); spare_b.reserve(spare_cap); spare_i.reserve(spare_cap);
+}
+
+void OrgArena::ReservePool(const size_t slots_, const size_t bytes, const size_t M)
+{
+  emp_assert(0 < slots_); emp_assert(0 < bytes);
+
+  // storage left behind by an earlier world on this thread
+  Release();
+  emp_assert(!IsActive());
+
+  SetStride(bytes);
+  slots = slots_;
+  live[0] = live[1] = 0;
+  mode = Mode::POOL;
+  Grow();
+  stats = Stats();
+
+  // vector buffers for two generations, already sized for M genes
+  spare_cap = 4 * slots;
+  spare_d.reserve(spare_cap); spare_b.reserve(spare_cap); spare_i.reserve(spare_cap);
+  for(size_t i = 0; i < spare_cap; ++i) {spare_d.emplace_back(); spare_d.back().reserve(M);}
+  for(size_t i = 0; i < 2 * slots; ++i) {spare_b.emplace_back(); spare_b.back().reserve(M);}
+}
+
+void OrgArena::Release()
+{
+  spare_d.clear(); spare_b.clear(); spare_i.clear();
+  spare_cap = 0;
+
+  // organisms still point into the arena
+  if(GetLive()) {return;}
+
+  for(auto chunk : chunks) {::operator delete(chunk);}
+  chunks.clear();
+  free_list = nullptr;
+  mode = Mode::HEAP;
+}
+
+void OrgArena::Grow()
+{
+  emp_assert(mode == Mode::POOL);
+
+  char * chunk = static_cast<char *>(::operator new(slots * stride));
+  chunks.push_back(chunk);
+  ++stats.heap;
+
+  // thread the new slots onto the free list
+  for(size_t i = slots; i-- > 0;)
+  {
+    void * slot = chunk + i * stride;
+    *static_cast<void **>(slot) = free_list;
+    free_list = slot;
+  }
+}
+
+void * OrgArena::Allocate(const size_t bytes)
+{
+  if(mode == Mode::HEAP) {return ::operator new(bytes);}
+  ++stats.allocs;
+
+  // organism bigger than a slot (not expected)
+  if(stride < bytes) {++stats.heap; return ::operator new(bytes);}
+
+  if(mode == Mode::POOL)
+  {
+    if(free_list) {++stats.reused;}
+    else {Grow();}
+
+    void * p = free_list;
+    free_list = *static_cast<void **>(p);
+    ++live[0];
+    return p;
+  }
+
+  // back buffer full
+  if(used[back] == slots) {++stats.heap; return ::operator new(bytes);}
+
+  void * p = chunks[back] + used[back] * stride;
+  ++used[back]; ++live[back];
+  ++stats.reused;
+  return p;
+}
+
+void OrgArena::Free(void * p)
+{
+  const size_t c = Which(p);
+  if(c == npos) {::operator delete(p); return;}
+  ++stats.frees;
+
+  if(mode == Mode::POOL)
+  {
+    emp_assert(0 < live[0]);
+    --live[0];
+    *static_cast<void **>(p) = free_list;
+    free_list = p;
+    return;
+  }
+
+  emp_assert(0 < live[c]);
+  --live[c];
+}
+
+bool OrgArena::Swap()
+{
+  const size_t front = 1 - back;
+  if(mode != Mode::BUFFERS || live[front]) {return false;}
+
+  used[front] = 0;
+  back = front;
+  return true;
+}
+
+#endif
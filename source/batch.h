@@ -0,0 +1,308 @@
+/// Runs many replicates / treatments in one process, one DiagWorld per run across a thread pool
+
+#ifndef DIA_BATCH_H
+#define DIA_BATCH_H
+
+///< standard headers
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+///< empirical headers
+#include "emp/base/vector.hpp"
+
+///< experiment headers
+#include "config.h"
+#include "parallel.h"
+#include "world.h"
+
+class BatchRunner
+{
+  // object types for consistency between working class
+  public:
+    // NAME=VALUE settings applied on top of the base configuration
+    using params_t = emp::vector<std::pair<std::string, std::string>>;
+
+    // one world to run
+    struct Run
+    {
+      // line of the batch file it came from (job number in a sweep)
+      size_t line = 0;
+      // settings that differ from the base configuration
+      params_t params;
+    };
+
+    // one NAME=VALUE token of a batch or sweep file
+    struct Setting
+    {
+      std::string name;
+      std::string value;
+      // SEED=a-b
+      bool range = false;
+      size_t seed_lo = 0;
+      size_t seed_hi = 0;
+    };
+
+  public:
+
+    // base is the fully parsed configuration (Dia.cfg + command line) every run starts from
+    BatchRunner(const DiaConfig & base)
+    {
+      std::ostringstream out;
+      base.Write(out);
+      base_cfg = out.str();
+    }
+
+    /**
+     * Read function:
+     *
+     * Parses a batch file, one parameter set per line, e.g.
+     *
+     *   SELECTION=4 DIAGNOSTIC=1 LEX_EPS=0.5 SEED=1-50 OUTPUT_DIR=./lex/DIA_STRUCT__EPS_0.5__SEED_{SEED}/
+     *
+     * Blank lines and lines starting with '#' are skipped.
+     * SEED=a-b expands the line into one run per seed, and {SEED} in OUTPUT_DIR is replaced by the seed
+     * (SEED_<seed>/ is appended to OUTPUT_DIR when a range is given without the placeholder).
+     *
+     * @param path batch file.
+     *
+     * @return false (and prints why) if the file is missing or a setting is unknown.
+     */
+    bool Read(const std::string & path);
+
+    /**
+     * Execute function:
+     *
+     * Runs every world to MAX_GENS, threads runs at a time.
+     * Each run writes to its own OUTPUT_DIR (created if missing), progress lines included (progress.log).
+     * Runs keep their own THREAD_CNT, so a node holds threads * THREAD_CNT busy threads.
+     *
+     * @param threads concurrent runs (0 = one per hardware thread).
+     *
+     * @return number of runs that could not be set up.
+     */
+    size_t Execute(size_t threads);
+
+    size_t GetRunCnt() const {return runs.size();}
+
+    // base configuration with the settings of run applied
+    void Configure(const Run & run, DiaConfig & config) const;
+
+    // configure and run a single world (safe to call from several threads)
+    bool RunOne(const Run & run);
+
+    /**
+     * Parse function:
+     *
+     * Splits a NAME=VALUE token, checks NAME is a setting and reads SEED=a-b as a seed range.
+     * Shared by batch and sweep files.
+     *
+     * @param what file kind for error messages (BATCH, SWEEP).
+     * @param line line of the file the token is on.
+     * @param tok token to parse.
+     * @param set parsed setting.
+     *
+     * @return false (and prints why) if the token is malformed, the setting unknown or the seed range empty.
+     */
+    static bool Parse(const std::string & what, const size_t line, const std::string & tok, Setting & set);
+
+    // report from any thread without interleaving lines
+    void Log(const std::string & msg)
+    {
+      std::lock_guard<std::mutex> guard(log_lock);
+      std::cerr << msg << std::endl;
+    }
+
+  private:
+    // add the runs described by one line of the batch file
+    bool Expand(const size_t line, const std::string & text);
+
+  private:
+    // base configuration in Dia.cfg format
+    std::string base_cfg;
+    // runs in batch file order
+    emp::vector<Run> runs;
+    // serializes progress messages
+    std::mutex log_lock;
+};
+
+bool BatchRunner::Read(const std::string & path)
+{
+  std::ifstream in(path);
+  if(!in.is_open()) {std::cerr << "BATCH FILE DOES NOT EXIST: " << path << std::endl; return false;}
+
+  std::string text;
+  for(size_t line = 1; std::getline(in, text); ++line)
+  {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if(first == std::string::npos || text[first] == '#') {continue;}
+    if(!Expand(line, text)) {return false;}
+  }
+
+  std::cerr << "Batch file " << path << " holds " << runs.size() << " runs" << std::endl;
+  return true;
+}
+
+bool BatchRunner::Parse(const std::string & what, const size_t line, const std::string & tok, Setting & set)
+{
+  const size_t eq = tok.find('=');
+  if(eq == std::string::npos || eq == 0)
+  {
+    std::cerr << what << " LINE " << line << ": EXPECTED NAME=VALUE, GOT " << tok << std::endl;
+    return false;
+  }
+
+  set = Setting();
+  set.name = tok.substr(0, eq); set.value = tok.substr(eq + 1);
+
+  // check the setting name against a scratch configuration
+  DiaConfig check;
+  if(!check.Has(set.name))
+  {
+    std::cerr << what << " LINE " << line << ": UNKNOWN SETTING " << set.name << std::endl;
+    return false;
+  }
+
+  // seed range
+  const size_t dash = set.value.find('-', 1);
+  if(set.name == "SEED" && dash != std::string::npos)
+  {
+    try
+    {
+      size_t used = 0;
+      const std::string lo = set.value.substr(0, dash), hi = set.value.substr(dash + 1);
+      set.seed_lo = std::stoul(lo, &used);
+      if(used != lo.size()) {throw std::invalid_argument(lo);}
+      set.seed_hi = std::stoul(hi, &used);
+      if(used != hi.size()) {throw std::invalid_argument(hi);}
+    }
+    catch(const std::logic_error &)
+    {
+      std::cerr << what << " LINE " << line << ": BAD SEED RANGE " << set.value << std::endl;
+      return false;
+    }
+    if(set.seed_hi < set.seed_lo) {std::cerr << what << " LINE " << line << ": EMPTY SEED RANGE " << set.value << std::endl; return false;}
+    set.range = true;
+  }
+
+  return true;
+}
+
+bool BatchRunner::Expand(const size_t line, const std::string & text)
+{
+  params_t params;
+  size_t seed_lo = 0, seed_hi = 0;
+  bool range = false;
+
+  std::istringstream tokens(text);
+  std::string tok;
+  while(tokens >> tok)
+  {
+    Setting set;
+    if(!Parse("BATCH", line, tok, set)) {return false;}
+
+    if(set.range) {seed_lo = set.seed_lo; seed_hi = set.seed_hi; range = true; continue;}
+    params.emplace_back(set.name, set.value);
+  }
+
+  if(!range) {runs.push_back({line, params}); return true;}
+
+  // one run per seed
+  for(size_t s = seed_lo; s <= seed_hi; ++s)
+  {
+    Run run{line, params};
+    run.params.emplace_back("SEED", std::to_string(s));
+
+    bool placed = false;
+    for(auto & p : run.params)
+    {
+      if(p.first != "OUTPUT_DIR") {continue;}
+      const size_t at = p.second.find("{SEED}");
+      if(at != std::string::npos) {p.second.replace(at, 6, std::to_string(s));}
+      else {p.second += "SEED_" + std::to_string(s) + "/";}
+      placed = true;
+    }
+    // no OUTPUT_DIR on the line: keep seeds apart under the base directory
+    if(!placed) {run.params.emplace_back("OUTPUT_DIR", "{BASE}SEED_" + std::to_string(s) + "/");}
+
+    runs.push_back(std::move(run));
+  }
+
+  return true;
+}
+
+size_t BatchRunner::Execute(size_t threads)
+{
+  if(threads == 0) {threads = std::max<size_t>(1, std::thread::hardware_concurrency());}
+  threads = std::min(threads, std::max<size_t>(1, runs.size()));
+  std::cerr << "Running " << runs.size() << " runs on " << threads << " threads" << std::endl;
+
+  std::atomic<size_t> failed{0};
+  ThreadPool pool(threads);
+  pool.ParallelFor(runs.size(), [this, &failed](size_t r)
+  {
+    if(!RunOne(runs[r])) {++failed;}
+  });
+
+  std::cerr << "Batch finished: " << runs.size() - failed << " of " << runs.size() << " runs completed" << std::endl;
+  return failed;
+}
+
+void BatchRunner::Configure(const Run & run, DiaConfig & config) const
+{
+  std::istringstream in(base_cfg);
+  config.Read(in);
+
+  for(const auto & p : run.params)
+  {
+    std::string value = p.second;
+    if(value.rfind("{BASE}", 0) == 0) {value = config.OUTPUT_DIR() + value.substr(6);}
+    config.Set(p.first, value);
+  }
+}
+
+bool BatchRunner::RunOne(const Run & run)
+{
+  DiaConfig config;
+  Configure(run, config);
+
+  std::error_code err;
+  std::filesystem::create_directories(config.OUTPUT_DIR(), err);
+  if(err)
+  {
+    Log("BATCH LINE " + std::to_string(run.line) + ": CANNOT CREATE " + config.OUTPUT_DIR() + " (" + err.message() + ")");
+    return false;
+  }
+
+  Log("Starting run (line " + std::to_string(run.line) + ", seed " + std::to_string(config.SEED()) + ") in " + config.OUTPUT_DIR());
+
+  // progress lines of concurrent runs would interleave on std::cout, so each run keeps its own log
+  std::ofstream progress(config.OUTPUT_DIR() + "progress.log", config.CHECKPOINT_RESUME() ? std::ios::app : std::ios::trunc);
+  if(!progress.is_open())
+  {
+    Log("BATCH LINE " + std::to_string(run.line) + ": CANNOT OPEN " + config.OUTPUT_DIR() + "progress.log");
+    return false;
+  }
+
+  {
+    DiagWorld world(config);
+    world.SetProgress(progress);
+    while (world.GetUpdate() <= config.MAX_GENS())
+    {
+      world.Update();
+    }
+  }
+
+  Log("Finished run (line " + std::to_string(run.line) + ", seed " + std::to_string(config.SEED()) + ")");
+  return true;
+}
+
+#endif
@@ -0,0 +1,273 @@
+/// Binary checkpoints of a full world state for exact restarts
+///
+/// File layout (native byte order):
+///
+///   header (72 bytes)
+///     char[8]   magic        "DIACHKPT"
+///     uint32    version      layout version (CKPT_VERSION)
+///     uint32    flags        unused (0)
+///     uint64    update       update the checkpoint was taken at (start of the update)
+///     uint64    seed         seed of the run (SEED, or the one emp::Random picked)
+///     uint64    pop_size     organisms N
+///     uint64    objectives   genes per organism M
+///     uint64    data_bytes   bytes of data.csv written so far
+///     uint64    phylo_bytes  bytes of phylodiversity.csv written so far
+///     uint64    snap_cnt     binary phylogeny snapshots written so far
+///
+///   body (sections written in this order by DiagWorld::WriteCheckpoint)
+///     double    genome[N*M]  (doubles in every build, so GENE_FLOAT=1 runs resume from either)
+///     tree      genotype systematics (CompactSystematics::Save)
+///     tree      phenotype systematics
+///     vec       ecoea resource amounts
+///
+/// A vec is a uint64 length followed by that many doubles.
+/// Files are written to <path>.tmp and renamed, so a kill mid-write leaves the previous checkpoint intact.
+
+#ifndef DIA_CHECKPOINT_H
+#define DIA_CHECKPOINT_H
+
+///< standard headers
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+///< constant vars
+constexpr uint32_t CKPT_VERSION = 1;
+
+struct CheckpointHeader
+{
+  char magic[8] = {'D','I','A','C','H','K','P','T'};
+  uint32_t version = CKPT_VERSION;
+  uint32_t flags = 0;
+  uint64_t update = 0;
+  uint64_t seed = 0;
+  uint64_t pop_size = 0;
+  uint64_t objectives = 0;
+  uint64_t data_bytes = 0;
+  uint64_t phylo_bytes = 0;
+  uint64_t snap_cnt = 0;
+
+  // right magic and layout version?
+  bool IsValid() const {return std::memcmp(magic, "DIACHKPT", 8) == 0 && version == CKPT_VERSION;}
+};
+
+static_assert(sizeof(CheckpointHeader) == 72, "checkpoint header must stay 72 bytes");
+
+class CheckpointWriter
+{
+  public:
+
+    // append a plain value
+    template <typename T>
+    void Put(const T & v)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "only plain values can be checkpointed");
+      const size_t at = bytes.size();
+      bytes.resize(at + sizeof(T));
+      std::memcpy(bytes.data() + at, &v, sizeof(T));
+    }
+
+    // append a length prefixed vector (stored as doubles)
+    template <typename T>
+    void PutVec(const emp::vector<T> & v)
+    {
+      Put<uint64_t>(v.size());
+      PutRaw(v.data(), v.size());
+    }
+
+    // append n values as doubles without a length
+    template <typename T>
+    void PutRaw(const T * v, const size_t n)
+    {
+      static_assert(std::is_floating_point<T>::value, "only floating point vectors can be checkpointed");
+      const size_t at = bytes.size();
+      bytes.resize(at + n * sizeof(double));
+      for(size_t i = 0; i < n; ++i)
+      {
+        const double d = static_cast<double>(v[i]);
+        std::memcpy(bytes.data() + at + i * sizeof(double), &d, sizeof(double));
+      }
+    }
+
+    /**
+     * Write File function:
+     *
+     * Writes to path.tmp and renames it over path once everything is on disk.
+     *
+     * @param path checkpoint file.
+     *
+     * @return false if the file could not be written.
+     */
+    bool WriteFile(const std::string & path) const;
+
+    size_t GetSize() const {return bytes.size();}
+
+  private:
+    // serialized checkpoint
+    emp::vector<char> bytes;
+};
+
+class CheckpointReader
+{
+  public:
+
+    // load a whole checkpoint file (false if missing)
+    bool ReadFile(const std::string & path)
+    {
+      std::ifstream in(path, std::ios::binary);
+      if(!in.is_open()) {return false;}
+
+      std::ostringstream all;
+      all << in.rdbuf();
+      const std::string data = all.str();
+      bytes.assign(data.begin(), data.end());
+      at = 0; ok = true;
+      return true;
+    }
+
+    // next plain value (zero and !Ok() once the file runs out)
+    template <typename T>
+    T Get()
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "only plain values can be checkpointed");
+      T v{};
+      if(!ok || bytes.size() < at + sizeof(T)) {ok = false; return v;}
+      std::memcpy(&v, bytes.data() + at, sizeof(T));
+      at += sizeof(T);
+      return v;
+    }
+
+    // next length prefixed vector of doubles (converted to T)
+    template <typename T = double>
+    emp::vector<T> GetVec()
+    {
+      emp::vector<T> v(Get<uint64_t>());
+      GetRaw(v.data(), v.size());
+      return v;
+    }
+
+    // next n doubles (converted to T)
+    template <typename T>
+    void GetRaw(T * v, const size_t n)
+    {
+      static_assert(std::is_floating_point<T>::value, "only floating point vectors can be checkpointed");
+      if(!ok || bytes.size() < at + n * sizeof(double)) {ok = false; return;}
+      for(size_t i = 0; i < n; ++i)
+      {
+        double d;
+        std::memcpy(&d, bytes.data() + at + i * sizeof(double), sizeof(double));
+        v[i] = static_cast<T>(d);
+      }
+      at += n * sizeof(double);
+    }
+
+    // every read so far was inside the file?
+    bool Ok() const {return ok;}
+
+    // everything has been read?
+    bool Done() const {return at == bytes.size();}
+
+  private:
+    // checkpoint contents
+    emp::vector<char> bytes;
+    // read position
+    size_t at = 0;
+    // no read has run past the end
+    bool ok = false;
+};
+
+bool CheckpointWriter::WriteFile(const std::string & path) const
+{
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if(!out) {std::cerr << "ERROR: UNABLE TO OPEN CHECKPOINT FILE " << tmp << std::endl; return false;}
+    out.write(bytes.data(), bytes.size());
+    out.flush();
+    if(!out) {std::cerr << "ERROR: UNABLE TO WRITE CHECKPOINT FILE " << tmp << std::endl; return false;}
+  }
+
+  if(std::rename(tmp.c_str(), path.c_str()) != 0)
+  {
+    std::cerr << "ERROR: UNABLE TO REPLACE CHECKPOINT FILE " << path << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// rows of a csv file (first column is the update) below update, with or without its header
+std::string CsvRows(const std::string & path, const bool header, const size_t update)
+{
+  std::ifstream in(path);
+  if(!in.is_open()) {return "";}
+
+  std::string kept, line;
+  if(std::getline(in, line) && header) {kept = line + "\n";}
+  while(std::getline(in, line))
+  {
+    if(line.empty()) {continue;}
+    if(update <= std::strtoull(line.c_str(), nullptr, 10)) {break;}
+    kept += line + "\n";
+  }
+
+  return kept;
+}
+
+/**
+ * Resume Csv function:
+ *
+ * For csv files the world opens by name (systematics files), which would be truncated on a restart.
+ * A resumed run writes them to path.resume instead; this folds any earlier path.resume back into path
+ * and cuts path back to the rows before update.
+ *
+ * @param path csv file whose first column is the update.
+ * @param update update the run resumes at.
+ *
+ * @return false if path could not be rewritten.
+ */
+bool ResumeCsv(const std::string & path, const size_t update)
+{
+  const std::string kept = CsvRows(path, true, update) + CsvRows(path + ".resume", false, update);
+
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if(!out) {std::cerr << "ERROR: UNABLE TO REWRITE " << path << std::endl; return false;}
+    out.write(kept.data(), kept.size());
+  }
+  if(std::rename(tmp.c_str(), path.c_str()) != 0) {return false;}
+
+  // only dropped once its rows are safely in path
+  std::remove((path + ".resume").c_str());
+  return true;
+}
+
+// append the rows a resumed run wrote to path.resume onto path (end of run)
+bool FinishCsv(const std::string & path)
+{
+  std::ifstream probe(path + ".resume");
+  if(!probe.is_open()) {return true;}
+  probe.close();
+
+  const std::string rows = CsvRows(path + ".resume", false, static_cast<size_t>(-1));
+  std::ofstream out(path, std::ios::binary | std::ios::app);
+  if(!out) {std::cerr << "ERROR: UNABLE TO APPEND TO " << path << std::endl; return false;}
+  out.write(rows.data(), rows.size());
+  out.close();
+
+  std::remove((path + ".resume").c_str());
+  return true;
+}
+
+#endif
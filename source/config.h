@@ -8,30 +8,42 @@ EMP_BUILD_CONFIG(DiaConfig,
   VALUE(POP_SIZE,     size_t,      512,    "Population size."),
   VALUE(MAX_GENS,     size_t,    40001,    "Maximum number of generations."),
   VALUE(SEED,           int,         0,    "Random number seed."),
+  VALUE(RNG_MODE,    size_t,         0,    "Random streams for mutation and selection? \n0: Shared emp::Random\n1: Counter based (Philox) keyed by seed, generation and offspring / selection event"),
+  VALUE(THREAD_CNT,  size_t,         1,    "Threads used by parallel population passes (1 = run inline)."),
+  VALUE(ORG_ALLOC,    size_t,         0,    "Where are organisms allocated? \n0: Heap\n1: Double buffered generations\n2: Recycling pool"),
 
   GROUP(DIAGNOSTICS, "How are the diagnostics setup?"),
   VALUE(TARGET,              double,     100.0,      "Target that traits are trying to optimize towards."),
   VALUE(ACCURACY,            double,      0.99,      "Accuracy percentage needed to be considered an optimal trait"),
+  VALUE(GENE_ROUNDING,       size_t,         0,      "Round mutated genes as if stored narrower? Emulated on top of the gene_t storage type, see GENE_FLOAT=1 for real float32 storage (for DataTools/Checker/precision-checker.py) \n0: No\n1: To float32\n2: To 16-bit fixed point scaled to TARGET"),
   VALUE(CREDIT,              double,      0.00,      "Maximum credit a solution can get on an objective if applicable"),
   VALUE(OBJECTIVE_CNT,       size_t,       100,      "Number of traits an organism has"),
   VALUE(SELECTION,           size_t,         0,      "Which selection are we doing? \n0: (μ,λ)\n1: Tournament\n2: Fitness Sharing\n3: Novelty Search\n4: Espilon Lexicase\n5: Down Sampled Lexicase \n6: Cohort Lexicase \n7: Novelty Lexicase"),
+  VALUE(FIXED_KERNELS,       bool,      true,      "Use compile time diagnostic kernels when OBJECTIVE_CNT is 10, 50, 100 or 1000?"),
   VALUE(DIAGNOSTIC,          size_t,         0,      "Which diagnostic are we doing? \n0: Exploitation\n1: Structured Exploitation\n2: Strong Ecology \n3: Exploration \n4: Weak Ecology"),
+  VALUE(SELECTION_ENGINE,    std::string,   "",      "Selection engine by name, overrides SELECTION if set (e.g. tournament, lexicase, cohort_lexicase)"),
+  VALUE(DIAGNOSTIC_ENGINE,   std::string,   "",      "Diagnostic engine by name, overrides DIAGNOSTIC if set (e.g. exploitation, exploration)"),
 
   GROUP(MUTATIONS, "Mutation rates for organisms."),
   VALUE(MUTATE_PER,       double,     0.007,        "Probability of instructions being mutated"),
   VALUE(MEAN,             double,     0.0,          "Mean of Gaussian Distribution for mutations"),
   VALUE(STD,              double,     1.0,          "Standard Deviation of Gaussian Distribution for mutations"),
+  VALUE(MUTATE_SKIP,      bool,       false,        "Use the geometric skip mutation kernel? (same distribution, different random stream)"),
+  VALUE(MUTATE_BATCH,     bool,       false,        "Copy and mutate all offspring genomes in one population-wide pass before births are registered?"),
 
   GROUP(PARAMETERS, "Parameter estimations all selection schemes."),
   VALUE(MU,               size_t,           512,       "Parameter estiamte for μ."),
   VALUE(TOUR_SIZE,        size_t,           512,       "Parameter estiamte for tournament size."),
+  VALUE(TOUR_BATCH,         bool,         false,       "Draw tournaments with replacement in one batched pass? (Tournament, FitnessSharing, NoveltySearch)"),
   VALUE(FIT_SIGMA,        double,           0.0,       "Parameter estiamte for proportion of similarity threshold sigma (based on maximum distance between solutions)."),
   VALUE(FIT_ALPHA,        double,           1.0,       "Parameter estiamte for penalty function shape alpha."),
   VALUE(PNORM_EXP,        double,           2.0,       "Paramter we are using for the p-norm function."),
   VALUE(NOVEL_K,          size_t,           256,       "Parameter estiamte k-nearest neighbors."),
   VALUE(LEX_EPS,          double,           1.0,       "Parameter estimate for lexicase epsilon."),
+  VALUE(LEX_REDUCE,       size_t,             0,       "Reduce the population before epsilon lexicase events? \n0: No\n1: Merge identical score rows & drop rows that can never win\n2: Merge identical score rows only"),
   VALUE(DSLEX_PROP,       double,           1.0,       "Parameter for down sampled proportion"),
   VALUE(COH_LEX_PROP,     double,           1.0,       "Parameter for cohort proportions"),
+  VALUE(COH_LEX_PARALLEL,   bool,         false,       "Run cohorts in parallel (THREAD_CNT threads, one random stream per cohort)?"),
 
   VALUE(RESOURCE_SELECT_RES_INFLOW, double, 50.0, "Resource in-flow (amount)"),
   VALUE(RESOURCE_SELECT_RES_OUTFLOW, double, 0.05, "Resource out-flow (rate)"),
@@ -39,12 +51,29 @@ EMP_BUILD_CONFIG(DiaConfig,
   VALUE(RESOURCE_SELECT_MAX_BONUS, double, 5.0, "What's the max bonus someone can get for consuming a resource?"),
   VALUE(RESOURCE_SELECT_COST, double, 0.0, "Cost of using a resource?"),
   VALUE(RESOURCE_SELECT_NICHE_WIDTH, double, 0.0, "Score necessary to count as attempting to use a resource"),
+  VALUE(RESOURCE_SELECT_LOG, bool, false, "Compare EcoEA fitnesses in log2 space? (no overflow/underflow at large objective counts)"),
 
   GROUP(OUTPUT, "Output parameter."),
   VALUE(SNAP_INTERVAL,             size_t,             1000,          "How many updates between prints?"),
+  VALUE(SNAP_FORMAT,               size_t,                0,          "Which phylogeny snapshot format? \n0: CSV\n1: Binary columnar"),
+  VALUE(SNAP_COMPRESS,               bool,            false,          "Deflate binary snapshots? (requires building with SNAPSHOT_ZLIB=1)"),
+  VALUE(SNAP_DELTA,                size_t,                0,          "Binary snapshots between full checkpoints, others only hold changed taxa (0 = always full)"),
   VALUE(DATA_INTERVAL,             size_t,                10,          "How many updates between writing data to file?"),
-  VALUE(PRINT_INTERVAL,            size_t,                 1,          "How many updates between prints?"),
-  VALUE(OUTPUT_DIR,           std::string,              "./",          "What directory are we dumping all this data")
+  VALUE(PRINT_INTERVAL,            size_t,                 1,          "How many updates between prints? (0 = never)"),
+  VALUE(OUTPUT_DIR,           std::string,              "./",          "What directory are we dumping all this data"),
+  VALUE(ASYNC_OUTPUT,                bool,            false,          "Write data.csv, phylodiversity.csv and binary snapshots from a background thread? (CSV snapshots and systematics files stay synchronous)"),
+  VALUE(ASYNC_QUEUE,               size_t,               64,          "How many pending writes can the background writer hold?"),
+  VALUE(CHECKPOINT_INTERVAL,       size_t,                0,          "How many updates between checkpoints of the full world state? (0 = never)\nWith RNG_MODE 0 each checkpoint reseeds the shared generator, so results differ from CHECKPOINT_INTERVAL 0 at the same SEED (run_config.csv: CHECKPOINT_RESEEDED)"),
+  VALUE(CHECKPOINT_RESUME,           bool,            false,          "Resume from OUTPUT_DIR/checkpoint.bin if one exists?"),
+  VALUE(TIMING,                    size_t,                0,          "Time each phase of a generation into OUTPUT_DIR/timing.csv? \n0: Off\n1: Steady clock\n2: Steady clock + cpu cycle counter"),
+
+  GROUP(SYSTEMATICS, "Phylogeny tracking parameters."),
+  VALUE(PHYLO_COMPACT,             size_t,                 0,          "How many updates between collapsing extinct unifurcating ancestors? (0 = never)"),
+
+  GROUP(BATCH, "Running many replicates in one process."),
+  VALUE(BATCH_FILE,           std::string,                "",          "File with one NAME=VALUE parameter set per line to run (empty = single run)"),
+  VALUE(SWEEP_FILE,           std::string,                "",          "Sweep specification (grid / list of treatments) to run longest first, skipping finished jobs"),
+  VALUE(BATCH_THREADS,             size_t,                 0,          "How many runs at once? (0 = one per hardware thread)")
 )
 
 #endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+/// EcoEA resource bonuses computed over a flat score matrix and flat resource levels
+///
+/// Fitness is base * 2^(bonus_1 + ... + bonus_M), which leaves the range of a double once
+/// M reaches the hundreds. In log space the engine returns log2(base) + sum of bonuses instead:
+/// the same ordering (tournaments only compare), computed with adds and never degenerate.
+
+#ifndef DIA_ECOEA_H
+#define DIA_ECOEA_H
+
+///< standard headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/math/math.hpp"
+
+class EcoEAEngine
+{
+  // object types for consistency between working class
+  public:
+    // vector of doubles (levels, fitnesses, flat score matrix)
+    using dvec_t = emp::vector<double>;
+
+  public:
+
+    /**
+     * One resource per objective, each starting at (and refilled by) inflow:
+     *
+     * @param M number of objectives (resources).
+     * @param inflow resource added per generation, split evenly across the population.
+     * @param frac fraction of a resource an organism can take.
+     * @param max_bonus largest bonus exponent from one resource.
+     * @param cost cost of using a resource.
+     * @param niche_width smallest bonus that is rewarded.
+     */
+    EcoEAEngine(const size_t M, const double _inflow, const double _frac, const double _max_bonus, const double _cost, const double _niche_width)
+      : obj_cnt(M), inflow(_inflow), frac(_frac), max_bonus(_max_bonus), cost(_cost), niche_width(_niche_width), levels(M, _inflow), bonus(M)
+    {
+      emp_assert(M > 0);
+    }
+
+    // (re)size the score matrix for N organisms
+    void Resize(const size_t N) {scores.resize(N * obj_cnt); fitness.resize(N);}
+
+    // row of organism i in the score matrix (M contiguous scores)
+    double * Row(const size_t i) {emp_assert(i * obj_cnt < scores.size()); return scores.data() + i * obj_cnt;}
+
+    /**
+     * Fitness function:
+     *
+     * Same arithmetic, in the same order, as the emp::ResourceSelect internals it replaces:
+     * organisms are visited in order (each one sees the levels left by the ones before it),
+     * and within an organism every resource is independent, so the level update and bonus are
+     * computed across all resources in straight loops before the bonuses are multiplied in.
+     *
+     * @param base base fitness of every organism (aggregate score).
+     * @param live organisms present, used to split the inflow.
+     * @param occupied which rows hold an organism (nullptr = all of them).
+     *
+     * @return fitness of every organism after its resource bonuses (0 for empty rows),
+     *         or its log2 in log space (-inf for empty rows and zero base fitness).
+     */
+    const dvec_t & Fitness(const dvec_t & base, const size_t live, const emp::vector<bool> * occupied = nullptr);
+
+    // return log2 fitnesses from Fitness()?
+    void SetLogSpace(const bool log) {log_space = log;}
+    bool GetLogSpace() const {return log_space;}
+
+    size_t GetObjectiveCnt() const {return obj_cnt;}
+    const dvec_t & GetLevels() const {return levels;}
+    void SetLevels(const dvec_t & l) {emp_assert(l.size() == obj_cnt); levels = l;}
+
+  private:
+    // objectives & resources
+    const size_t obj_cnt;
+    // resource parameters
+    const double inflow, frac, max_bonus, cost, niche_width;
+    // fitnesses as log2(base) + sum of bonuses
+    bool log_space = false;
+
+    // resource levels
+    dvec_t levels;
+    // population scores, row major (N x M)
+    dvec_t scores;
+    // bonus exponents of the organism being processed
+    dvec_t bonus;
+    // resulting fitnesses
+    dvec_t fitness;
+};
+
+const EcoEAEngine::dvec_t & EcoEAEngine::Fitness(const dvec_t & base, const size_t live, const emp::vector<bool> * occupied)
+{
+  const size_t N = fitness.size();
+  emp_assert(base.size() == N); emp_assert(scores.size() == N * obj_cnt);
+  emp_assert(!occupied || occupied->size() == N);
+
+  const double inc = inflow / live;
+  double * lvl = levels.data();
+  double * bon = bonus.data();
+
+  for(size_t i = 0; i < N; ++i)
+  {
+    if(occupied && !(*occupied)[i]) {fitness[i] = log_space ? -std::numeric_limits<double>::infinity() : 0.0; continue;}
+    const double * row = scores.data() + i * obj_cnt;
+
+    // resource share, kept identical to emp::Pow(score, 2.0)
+    for(size_t j = 0; j < obj_cnt; ++j) {bon[j] = emp::Pow(row[j], 2.0);}
+
+    // level update & bonus exponent, no dependency between resources
+    for(size_t j = 0; j < obj_cnt; ++j)
+    {
+      lvl[j] += inc;
+      double cur = bon[j] * (frac * (lvl[j] - cost));
+      cur = (cur > niche_width) ? cur - cost : 0.0;
+      cur = std::min(cur, max_bonus);
+      lvl[j] -= std::abs(cur);
+      bon[j] = cur;
+    }
+
+    // log2 of the product below: bonus exponents simply add up
+    if(log_space)
+    {
+      double sum = 0.0;
+      for(size_t j = 0; j < obj_cnt; ++j) {sum += bon[j];}
+      fitness[i] = std::log2(base[i]) + sum;
+      continue;
+    }
+
+    // bonuses multiplied in resource order
+    double fit = base[i];
+    for(size_t j = 0; j < obj_cnt; ++j) {fit *= emp::Pow2(bon[j]);}
+    fitness[i] = fit;
+  }
+
+  return fitness;
+}
+
+#endif
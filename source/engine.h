@@ -0,0 +1,72 @@
+/// Named selection & diagnostic engines, so scheme variants plug in without touching the world's dispatch
+
+#ifndef DIA_ENGINE_H
+#define DIA_ENGINE_H
+
+///< standard headers
+#include <map>
+#include <string>
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+#include "emp/base/vector.hpp"
+
+///< constant vars
+
+// per generation inputs an engine can ask the world for (or-ed together)
+enum EngineData : size_t
+{
+  DATA_NONE = 0,
+  // aggregate score per org
+  DATA_AGGREGATE = 1,
+  // score vector per org
+  DATA_SCORES = 2,
+  // genome per org
+  DATA_GENOMES = 4,
+  // score vector + novelty column per org (implies DATA_SCORES)
+  DATA_NOVELTY = 8
+};
+
+template <typename ENGINE>
+class EngineRegistry
+{
+  public:
+
+    /**
+     * Add function:
+     *
+     * Registers an engine under a name. Engines should be added before any world that uses them is built
+     * (the registry is read, not locked, while worlds run).
+     *
+     * @param name name used in the configuration.
+     * @param engine engine to register.
+     *
+     * @return false if the name is already taken.
+     */
+    bool Add(const std::string & name, const ENGINE & engine)
+    {
+      return engines.emplace(name, engine).second;
+    }
+
+    bool Has(const std::string & name) const {return engines.count(name) > 0;}
+
+    const ENGINE & Get(const std::string & name) const
+    {
+      emp_assert(Has(name), name);
+      return engines.at(name);
+    }
+
+    // registered names, sorted
+    emp::vector<std::string> Names() const
+    {
+      emp::vector<std::string> names;
+      for(const auto & e : engines) {names.push_back(e.first);}
+      return names;
+    }
+
+  private:
+    // engines by name
+    std::map<std::string, ENGINE> engines;
+};
+
+#endif
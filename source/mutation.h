@@ -0,0 +1,168 @@
+/// Gaussian mutation kernel that only visits the genes it mutates
+
+#ifndef DIA_MUTATION_H
+#define DIA_MUTATION_H
+
+///< standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+///< empirical headers
+#include "emp/base/vector.hpp"
+#include "emp/math/Random.hpp"
+
+///< experiment headers
+#include "precision.h"
+
+///< constant vars
+constexpr double MUT_TWO_PI = 6.283185307179586476925286766559;
+// offspring rows sharing one random stream in a batched pass
+constexpr size_t MUT_BATCH_ROWS = 64;
+// upper bound on per stream seeds
+constexpr uint32_t MUT_SEED_MAX = 2000000000;
+
+class MutationKernel
+{
+  // object types for consistency between working class
+  public:
+    // genome vector type (gene_t, see precision.h)
+    using genome_t = emp::vector<gene_t>;
+    // vector of gene positions
+    using ids_t = emp::vector<size_t>;
+
+  public:
+
+    MutationKernel(const double _rate, const double _mean, const double _std, const double _target)
+      : rate(_rate), mean(_mean), sd(_std), target(_target), log_q(std::log1p(-_rate))
+    {
+      emp_assert(0.0 <= rate); emp_assert(rate <= 1.0);
+      emp_assert(0.0 <= target);
+    }
+
+    /**
+     * Mutate function:
+     *
+     * Same distribution as testing P(rate) at every gene and adding N(mean, std) where it passes.
+     * Gaps between mutated genes are drawn from a geometric distribution, so the cost is the number of mutations.
+     * Mutations past the target reflect back under it, mutations below zero clamp to zero.
+     *
+     * @param genome genome to mutate in place.
+     * @param random random number generator (emp::Random or CounterRandom).
+     *
+     * @return number of mutated genes (positions in GetChanged()).
+     */
+    template <typename RNG>
+    size_t Mutate(genome_t & genome, RNG & random) {return Mutate(genome.data(), genome.size(), random);}
+
+    // same as above on a genome stored in a contiguous block (M genes starting at genome)
+    template <typename RNG>
+    size_t Mutate(gene_t * genome, const size_t M, RNG & random);
+
+    // positions changed by the last Mutate call (ascending)
+    const ids_t & GetChanged() const {return changed;}
+
+    // round mutated genes to a reduced precision (emulated, still stored as gene_t)
+    void SetPrecision(const GeneCodec & c) {codec = c;}
+
+  private:
+    // pick mutated positions by geometric skips
+    template <typename RNG>
+    void Sites(const size_t M, RNG & random);
+
+    // fill delta with one N(mean, std) deviate per mutated position
+    template <typename RNG>
+    void Normals(const size_t n, RNG & random);
+
+  private:
+    // per gene mutation probability
+    double rate;
+    // gaussian mean
+    double mean;
+    // gaussian standard deviation
+    double sd;
+    // value mutations reflect off
+    double target;
+    // ln(1 - rate) used by the geometric skips
+    double log_q;
+    // precision mutated genes are rounded to
+    GeneCodec codec;
+
+    // mutated positions
+    ids_t changed;
+    // batched uniform draws
+    emp::vector<double> u1, u2;
+    // gaussian deltas for the mutated positions
+    emp::vector<double> delta;
+};
+
+template <typename RNG>
+size_t MutationKernel::Mutate(gene_t * genome, const size_t M, RNG & random)
+{
+  Sites(M, random);
+  Normals(changed.size(), random);
+
+  // branch free reflect at target and clamp at zero
+  const double two_t = 2.0 * target;
+  for(size_t k = 0; k < changed.size(); ++k)
+  {
+    // arithmetic in double, stored back in gene_t
+    gene_t & gene = genome[changed[k]];
+    const double x = std::max(static_cast<double>(gene) + delta[k], 0.0);
+    gene = static_cast<gene_t>(codec.Round((target < x) ? two_t - x : x));
+  }
+
+  return changed.size();
+}
+
+template <typename RNG>
+void MutationKernel::Sites(const size_t M, RNG & random)
+{
+  changed.clear();
+
+  // nothing to skip over
+  if(rate <= 0.0) {return;}
+  if(1.0 <= rate)
+  {
+    changed.resize(M);
+    for(size_t i = 0; i < M; ++i) {changed[i] = i;}
+    return;
+  }
+
+  // number of untouched genes before the next mutation ~ Geometric(rate)
+  size_t i = 0;
+  while(i < M)
+  {
+    const double skip = std::floor(std::log(1.0 - random.GetDouble()) / log_q);
+    if(static_cast<double>(M - i) <= skip) {break;}
+
+    i += static_cast<size_t>(skip);
+    changed.push_back(i);
+    ++i;
+  }
+}
+
+template <typename RNG>
+void MutationKernel::Normals(const size_t n, RNG & random)
+{
+  // Box-Muller makes deviates in pairs
+  const size_t pairs = (n + 1) / 2;
+  u1.resize(pairs); u2.resize(pairs); delta.resize(2 * pairs);
+
+  // draw first so the transform loop has no calls into the generator
+  for(size_t p = 0; p < pairs; ++p)
+  {
+    u1[p] = 1.0 - random.GetDouble();
+    u2[p] = random.GetDouble();
+  }
+
+  for(size_t p = 0; p < pairs; ++p)
+  {
+    const double r = sd * std::sqrt(-2.0 * std::log(u1[p]));
+    const double theta = MUT_TWO_PI * u2[p];
+    delta[2 * p] = mean + r * std::cos(theta);
+    delta[2 * p + 1] = mean + r * std::sin(theta);
+  }
+}
+
+#endif
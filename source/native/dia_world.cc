@@ -9,6 +9,8 @@
 #include "../config.h"
 #include "../world.h"
 #include "../org.h"
+#include "../batch.h"
+#include "../sweep.h"
 
 // Hello world
 
@@ -27,6 +29,21 @@ int main(int argc, char* argv[])
   std::cout << "==============================\n"
             << std::endl;
 
+  // resumable parameter sweep, longest jobs first
+  if (config.SWEEP_FILE() != "")
+  {
+    SweepScheduler sweep(config);
+    if (sweep.Read(config.SWEEP_FILE()) == false) return 1;
+    return sweep.Execute(config.BATCH_THREADS()) == 0 ? 0 : 1;
+  }
+
+  // many runs on a thread pool, each starting from the configuration above
+  if (config.BATCH_FILE() != "")
+  {
+    BatchRunner batch(config);
+    if (batch.Read(config.BATCH_FILE()) == false) return 1;
+    return batch.Execute(config.BATCH_THREADS()) == 0 ? 0 : 1;
+  }
 
   DiagWorld world(config);
 
@@ -5,10 +5,15 @@
 
 ///< standard headers
 #include <algorithm>
+#include <array>
 
 ///< empirical headers
 #include "emp/base/vector.hpp"
 
+///< experiment headers
+#include "arena.h"
+#include "precision.h"
+
 ///< coordiante we start from
 constexpr double START_DB = 0.0;
 constexpr size_t START_ST = 0;
@@ -17,12 +22,14 @@ constexpr size_t START_ST = 0;
 class Org
 {
   public:
-    // genome vector type
-    using genome_t = emp::vector<double>;
+    // genome vector type (gene_t, see precision.h)
+    using genome_t = emp::vector<gene_t>;
     // score vector type
-    using score_t = emp::vector<double>;
+    using score_t = emp::vector<gene_t>;
     // optimal gene vector type
     using optimal_t = emp::vector<bool>;
+    // gene position vector type
+    using ids_t = emp::vector<size_t>;
 
   public:
     // for initial population
@@ -32,6 +39,7 @@ class Org
       emp_assert(genome.size() == 0); emp_assert(M == 0);
       M = _m;
       start_pos = _m;
+      TakeBuffers();
       genome.resize(_m, START_DB);
     }
 
@@ -42,6 +50,7 @@ class Org
       emp_assert(genome.size() == 0); emp_assert(M == 0);
       M = _g.size();
       start_pos = _g.size();
+      TakeBuffers();
       genome.resize(M);
       std::copy(_g.begin(), _g.end(), genome.begin());
     }
@@ -49,10 +58,14 @@ class Org
     // ask Charles
     Org(const Org &) = default;
     Org(Org &&) = default;
-    ~Org() { ; }
+    ~Org() { GiveBuffers(); }
     Org &operator=(const Org &) = default;
     Org &operator=(Org &&) = default;
 
+    // organisms live in the generation arena when one is reserved (arena.h)
+    static void * operator new(size_t bytes) {return OrgArena::Local().Allocate(bytes);}
+    static void operator delete(void * p) {OrgArena::Local().Free(p);}
+
     ///< getters
 
     // const + reference to
@@ -83,6 +96,8 @@ class Org
     bool GetAggregated() {return aggregated;}
     // get counted bool
     bool GetCounted() {return counted;}
+    // genes changed by mutation since birth
+    const ids_t & GetMutated() const {return mutated;}
 
     ///< setters
 
@@ -106,6 +121,23 @@ class Org
       std::copy(o_.begin(), o_.end(), optimal.begin());
     }
 
+    // set score & optimal gene vectors from fixed size buffers (FixedDiagnostic in problem.h)
+    template <size_t N>
+    void SetScore(const std::array<gene_t, N> & s_)
+    {
+      emp_assert(!scored); emp_assert(N == M); emp_assert(score.size() == 0); emp_assert(0 < M);
+      scored = true;
+      score.assign(s_.begin(), s_.end());
+    }
+
+    template <size_t N>
+    void SetOptimal(const std::array<bool, N> & o_)
+    {
+      emp_assert(!opti); emp_assert(N == M); emp_assert(optimal.size() == 0); emp_assert(0 < M);
+      opti = true;
+      optimal.assign(o_.begin(), o_.end());
+    }
+
     // set the optimal gene count (called from world.h or inherited from parent)
     void SetCount(size_t c_)
     {
@@ -122,6 +154,13 @@ class Org
       agg_score = a_;
     }
 
+    // set the genes changed by mutation (called from the mutation kernel in world.h)
+    void SetMutated(const ids_t & m_)
+    {
+      OrgArena::Local().Fit(mutated, m_.size());
+      mutated.assign(m_.begin(), m_.end());
+    }
+
     // set the starting position
     void SetStart(size_t s_)
     {
@@ -193,6 +232,21 @@ class Org
     */
     void MeClone() {emp_assert(0 < M); emp_assert(!clone); clone = true;}
 
+  private:
+    // reuse vector storage left behind by dead organisms (no-op without an arena)
+    void TakeBuffers()
+    {
+      OrgArena & arena = OrgArena::Local();
+      arena.Take(genome); arena.Take(score); arena.Take(optimal); arena.Take(mutated);
+    }
+
+    // leave vector storage for the next organism
+    void GiveBuffers()
+    {
+      OrgArena & arena = OrgArena::Local();
+      arena.Give(genome); arena.Give(score); arena.Give(optimal); arena.Give(mutated);
+    }
+
   private:
     // organism genome vector
     genome_t genome;
@@ -227,6 +281,9 @@ class Org
 
     // Are we a clone?
     bool clone = false;
+
+    // genes changed by mutation since birth
+    ids_t mutated;
 };
 
 ///< getters with extra
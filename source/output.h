@@ -0,0 +1,242 @@
+/// Output streams and background writer used for data files and snapshots
+
+#ifndef DIA_OUTPUT_H
+#define DIA_OUTPUT_H
+
+///< standard headers
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+
+///< constant vars
+constexpr size_t ASYNC_IDLE_US = 100;
+
+class AsyncWriter
+{
+  // object types for consistency between working class
+  public:
+    // a chunk of bytes headed for a file
+    struct Job
+    {
+      // destination file
+      std::string path;
+      // bytes to write
+      std::string data;
+      // replace the whole file (snapshots) instead of appending to it (data files)
+      bool whole = false;
+      // first append keeps the bytes already in the file (resumed runs)
+      bool keep = false;
+    };
+
+  public:
+
+    AsyncWriter(size_t capacity) : ring(capacity + 1)
+    {
+      emp_assert(0 < capacity);
+      worker = std::thread([this]() { Run(); });
+    }
+
+    ~AsyncWriter() {Close();}
+
+    ///< simulation thread side
+
+    // append bytes to a streaming file (first append truncates unless keep)
+    void Append(const std::string & path, std::string && data, const bool keep = false) {Push({path, std::move(data), false, keep});}
+
+    // replace a file with the given bytes
+    void WriteFile(const std::string & path, std::string && data) {Push({path, std::move(data), true, false});}
+
+    // block until every job pushed so far is on disk (before a checkpoint records file sizes)
+    void Flush()
+    {
+      while(written.load(std::memory_order_acquire) != pushed) {std::this_thread::yield();}
+    }
+
+    /**
+     * Close function:
+     *
+     * Blocks until every queued job has been written in order, then flushes and closes all files.
+     * Safe to call more than once.
+     */
+    void Close()
+    {
+      if(!worker.joinable()) {return;}
+      done.store(true, std::memory_order_release);
+      worker.join();
+    }
+
+    // number of times the simulation thread found the queue full
+    size_t GetStalls() const {return stalls;}
+
+  private:
+    // hand a job to the writer thread, waiting while the ring is full
+    void Push(Job && job)
+    {
+      emp_assert(worker.joinable());
+      const size_t t = tail.load(std::memory_order_relaxed);
+      const size_t next = (t + 1) % ring.size();
+
+      while(next == head.load(std::memory_order_acquire)) {++stalls; std::this_thread::yield();}
+
+      ring[t] = std::move(job);
+      ++pushed;
+      tail.store(next, std::memory_order_release);
+    }
+
+    // writer thread loop
+    void Run()
+    {
+      while(true)
+      {
+        const size_t h = head.load(std::memory_order_relaxed);
+
+        // nothing queued: stop if the simulation is done, otherwise idle
+        if(h == tail.load(std::memory_order_acquire))
+        {
+          if(done.load(std::memory_order_acquire) && h == tail.load(std::memory_order_acquire)) {break;}
+          std::this_thread::sleep_for(std::chrono::microseconds(ASYNC_IDLE_US));
+          continue;
+        }
+
+        Job job = std::move(ring[h]);
+        head.store((h + 1) % ring.size(), std::memory_order_release);
+        Write(job);
+        written.fetch_add(1, std::memory_order_release);
+      }
+
+      for(auto & f : files) {f.second.flush();}
+      files.clear();
+    }
+
+    // write a single job (writer thread only)
+    void Write(const Job & job)
+    {
+      if(job.whole)
+      {
+        std::ofstream out(job.path, std::ios::binary | std::ios::trunc);
+        if(!out) {std::cerr << "ERROR: UNABLE TO OPEN OUTPUT FILE " << job.path << std::endl; return;}
+        out.write(job.data.data(), job.data.size());
+        return;
+      }
+
+      auto it = files.find(job.path);
+      if(it == files.end())
+      {
+        const auto mode = std::ios::binary | (job.keep ? std::ios::app : std::ios::trunc);
+        it = files.emplace(job.path, std::ofstream(job.path, mode)).first;
+        if(!it->second) {std::cerr << "ERROR: UNABLE TO OPEN OUTPUT FILE " << job.path << std::endl;}
+      }
+      it->second.write(job.data.data(), job.data.size());
+      it->second.flush();
+    }
+
+  private:
+    // bounded single producer / single consumer ring
+    emp::vector<Job> ring;
+    // next slot the writer reads
+    std::atomic<size_t> head{0};
+    // next slot the simulation fills
+    std::atomic<size_t> tail{0};
+    // no more jobs will be pushed
+    std::atomic<bool> done{false};
+    // simulation side count of full-queue waits
+    size_t stalls = 0;
+    // jobs pushed (simulation side) and fully written (writer side)
+    size_t pushed = 0;
+    std::atomic<size_t> written{0};
+
+    // background writer thread
+    std::thread worker;
+    // streaming files held open by the writer thread
+    std::map<std::string, std::ofstream> files;
+};
+
+class OutputStream
+{
+  public:
+
+    OutputStream(const std::string & _path) : path(_path) {;}
+
+    // stream an emp::DataFile writes into
+    std::ostream & GetStream() {return buffer;}
+
+    // file this stream ends up in
+    const std::string & GetPath() const {return path;}
+
+    // route drained text through a background writer (nullptr writes directly)
+    void SetWriter(emp::Ptr<AsyncWriter> w) {writer = w;}
+
+    // bytes handed to the file so far (including any kept on resume)
+    size_t GetWritten() const {return written;}
+
+    /**
+     * Resume function:
+     *
+     * Continues a file from a checkpoint: the file is cut back to bytes and later drains append to it.
+     * Anything already streamed (the header) is dropped, the kept bytes hold it.
+     *
+     * @param bytes size of the file when the checkpoint was taken.
+     *
+     * @return false if the file is shorter than bytes.
+     */
+    bool Resume(const size_t bytes)
+    {
+      buffer.str("");
+      written = bytes;
+      keep = true;
+
+      std::error_code err;
+      const auto size = std::filesystem::file_size(path, err);
+      if(err || size < bytes) {return false;}
+      std::filesystem::resize_file(path, bytes, err);
+      return !err;
+    }
+
+    /**
+     * Drain function:
+     *
+     * Moves everything written to the stream so far to its file.
+     * Text goes to the background writer when one is set, otherwise straight to disk.
+     */
+    void Drain()
+    {
+      std::string data = buffer.str();
+      if(data.empty()) {return;}
+      buffer.str("");
+      written += data.size();
+
+      if(writer) {writer->Append(path, std::move(data), keep); return;}
+
+      if(!file.is_open()) {file.open(path, std::ios::binary | (keep ? std::ios::app : std::ios::trunc));}
+      file.write(data.data(), data.size());
+      file.flush();
+    }
+
+  private:
+    // destination file
+    std::string path;
+    // text waiting to be drained
+    std::ostringstream buffer;
+    // background writer (optional)
+    emp::Ptr<AsyncWriter> writer = nullptr;
+    // direct file when no writer is set
+    std::ofstream file;
+    // bytes handed to the file so far
+    size_t written = 0;
+    // append to the existing file instead of truncating it (resumed runs)
+    bool keep = false;
+};
+
+#endif
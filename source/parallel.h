@@ -0,0 +1,139 @@
+/// Small persistent thread pool for data parallel passes over the population
+
+#ifndef DIA_PARALLEL_H
+#define DIA_PARALLEL_H
+
+///< standard headers
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+///< empirical headers
+#include "emp/base/vector.hpp"
+
+class ThreadPool
+{
+  // object types for consistency between working class
+  public:
+    // body of a parallel loop, called once per index
+    using body_t = std::function<void(size_t)>;
+
+  public:
+
+    // threads counts the calling thread, so ThreadPool(1) runs everything inline
+    ThreadPool(const size_t threads)
+    {
+      for(size_t t = 1; t < threads; ++t) {workers.emplace_back([this]() { Work(); });}
+    }
+
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+      }
+      wake.notify_all();
+      for(auto & w : workers) {w.join();}
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // total threads taking part in a loop (workers + caller)
+    size_t GetThreadCnt() const {return workers.size() + 1;}
+
+    /**
+     * Parallel For function:
+     *
+     * Calls fun(i) for every i in [0,n) across the pool and the calling thread.
+     * Indices are handed out dynamically, so results must not depend on which thread runs an index.
+     * Returns once every call has finished.
+     *
+     * @param n number of indices.
+     * @param fun loop body.
+     */
+    void ParallelFor(const size_t n, const body_t & fun);
+
+  private:
+    // worker thread loop
+    void Work();
+
+    // run indices until none are left
+    void Drain()
+    {
+      for(size_t i = next++; i < job_n; i = next++) {(*job)(i);}
+    }
+
+  private:
+    // worker threads (caller is not included)
+    emp::vector<std::thread> workers;
+
+    // guards the job hand off
+    std::mutex lock;
+    // signals workers that a new loop (or stop) is ready
+    std::condition_variable wake;
+    // signals the caller that every worker is done
+    std::condition_variable finished;
+
+    // current loop body and size
+    const body_t * job = nullptr;
+    size_t job_n = 0;
+    // next index to hand out
+    std::atomic<size_t> next{0};
+    // workers still running the current loop
+    size_t active = 0;
+    // loops started so far (workers wait for this to change)
+    size_t round = 0;
+    // pool is shutting down
+    bool stop = false;
+};
+
+void ThreadPool::ParallelFor(const size_t n, const body_t & fun)
+{
+  // nothing to share
+  if(workers.size() == 0 || n <= 1)
+  {
+    for(size_t i = 0; i < n; ++i) {fun(i);}
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    job = &fun;
+    job_n = n;
+    next = 0;
+    active = workers.size();
+    ++round;
+  }
+  wake.notify_all();
+
+  // caller helps out
+  Drain();
+
+  std::unique_lock<std::mutex> guard(lock);
+  finished.wait(guard, [this]() { return active == 0; });
+  job = nullptr;
+}
+
+void ThreadPool::Work()
+{
+  size_t seen = 0;
+  std::unique_lock<std::mutex> guard(lock);
+
+  while(true)
+  {
+    wake.wait(guard, [this, &seen]() { return stop || round != seen; });
+    if(stop) {return;}
+    seen = round;
+
+    guard.unlock();
+    Drain();
+    guard.lock();
+
+    if(--active == 0) {finished.notify_one();}
+  }
+}
+
+#endif
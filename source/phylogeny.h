@@ -0,0 +1,410 @@
+/// Systematics manager extensions used for long evolutionary runs
+
+#ifndef DIA_PHYLOGENY_H
+#define DIA_PHYLOGENY_H
+
+///< standard headers
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
+///< empirical headers
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+#include "emp/Evolve/Systematics.hpp"
+
+///< experiment headers
+#include "checkpoint.h"
+
+template <typename ORG, typename ORG_INFO, typename DATA_STRUCT>
+class CompactSystematics : public emp::Systematics<ORG, ORG_INFO, DATA_STRUCT>
+{
+  // object types for consistency between working class
+  public:
+    // empirical systematics manager we are extending
+    using base_t = emp::Systematics<ORG, ORG_INFO, DATA_STRUCT>;
+    // taxon type held in the tree
+    using taxon_t = typename base_t::taxon_t;
+    // taxon pointer
+    using taxon_p = emp::Ptr<taxon_t>;
+    // extra branch length collapsed onto a taxon (keyed by taxon id)
+    using branch_t = std::unordered_map<size_t, size_t>;
+
+  public:
+
+    CompactSystematics(std::function<ORG_INFO(const ORG &)> calc_taxon) : base_t(calc_taxon) {;}
+
+    ///< tree compaction
+
+    /**
+     * Compact function:
+     *
+     * Collapses every unifurcating chain of extinct ancestors into a single edge.
+     * A removed ancestor gives its branch length to its only offspring, which is relinked to the grandparent.
+     * Root taxa are left alone so the tree stays rooted at the original ancestor.
+     *
+     * @return number of ancestor taxa freed.
+     */
+    size_t Compact();
+
+    // total number of ancestor taxa removed over the run
+    size_t GetCompacted() const {return compacted;}
+
+    // branch length of the edge leading into a taxon
+    size_t BranchLength(taxon_p tax) const;
+
+    // every taxon currently held in the tree
+    emp::vector<taxon_p> GetTaxa() const
+    {
+      emp::vector<taxon_p> taxa(this->active_taxa.begin(), this->active_taxa.end());
+      taxa.insert(taxa.end(), this->ancestor_taxa.begin(), this->ancestor_taxa.end());
+      taxa.insert(taxa.end(), this->outside_taxa.begin(), this->outside_taxa.end());
+      return taxa;
+    }
+
+
+    ///< branch length aware phylodiversity
+
+    /**
+     * Phylogenetic Diversity:
+     *
+     * Sum of all branch lengths in the tree.
+     * Matches emp::Systematics::GetPhylogeneticDiversity when nothing has been collapsed.
+     *
+     * @return phylogenetic diversity of the (possibly compacted) tree.
+     */
+    double GetCompactPhylogeneticDiversity() const;
+
+    /**
+     * Pairwise Distances:
+     *
+     * Branch length distance between every pair of active taxa.
+     *
+     * @return vector holding all pairwise distances.
+     */
+    emp::vector<double> GetCompactPairwiseDistances() const;
+
+    // data node tracking branch length aware phylogenetic diversity
+    auto AddCompactPhylogeneticDiversityDataNode(const std::string & name = "phylogenetic_diversity")
+    {
+      auto node = this->AddDataNode(name);
+      node->AddPullSet([this]() {
+        return emp::vector<double>({GetCompactPhylogeneticDiversity()});
+      });
+      return node;
+    }
+
+    // data node tracking branch length aware pairwise distance
+    auto AddCompactPairwiseDistanceDataNode(const std::string & name = "pairwise_distance")
+    {
+      auto node = this->AddDataNode(name);
+      node->AddPullSet([this]() {
+        return GetCompactPairwiseDistances();
+      });
+      return node;
+    }
+
+    ///< checkpointing
+
+    /**
+     * Save function:
+     *
+     * Writes the manager counters, every taxon (sorted by id) and the taxon at each population position.
+     * Rows hold parent, times, counts, collapsed branch length, info and data.
+     * DATA_STRUCT must provide Save(CheckpointWriter &) and Load(CheckpointReader &).
+     *
+     * @param out checkpoint being written.
+     */
+    void Save(CheckpointWriter & out) const;
+
+    /**
+     * Load function:
+     *
+     * Rebuilds a saved tree into a manager that has not tracked any organism yet.
+     * Taxa are recreated in id order, so every parent exists before its offspring.
+     * Positions go into both location maps, so the systematics update at the start of the next world update
+     * leaves them in place whether or not it swaps the maps.
+     *
+     * @param in checkpoint being read.
+     *
+     * @return false if the checkpoint is malformed.
+     */
+    bool Load(CheckpointReader & in);
+
+  private:
+    // gives access to the protected fields of a taxon (parent link, counters) that emp::Taxon has no setters for
+    // &TaxonLink::field names the emp::Taxon member itself, so writes go through the compiler, not through offsets;
+    // the checks below fail the build if those members change name or type, and each write is read back through
+    // the public getters
+    struct TaxonLink : public taxon_t
+    {
+      // moves a taxon past a removed ancestor
+      static void Relink(taxon_t & tax, taxon_p parent)
+      {
+        static_assert(std::is_same<decltype(&TaxonLink::parent), taxon_p taxon_t::*>::value, "emp::Taxon::parent changed");
+        tax.*(&TaxonLink::parent) = parent;
+        emp_assert(tax.GetParent() == parent);
+      }
+
+      // counters a rebuilt taxon would otherwise derive from its (incomplete) history, false if they do not read back
+      static bool Restore(taxon_t & tax, size_t orgs, size_t tot, size_t off, size_t tot_off, size_t dep)
+      {
+        static_assert(sizeof(TaxonLink) == sizeof(taxon_t), "TaxonLink must not add members to emp::Taxon");
+        static_assert(std::is_same<decltype(&TaxonLink::num_orgs), size_t taxon_t::*>::value, "emp::Taxon::num_orgs changed");
+        static_assert(std::is_same<decltype(&TaxonLink::tot_orgs), size_t taxon_t::*>::value, "emp::Taxon::tot_orgs changed");
+        static_assert(std::is_same<decltype(&TaxonLink::num_offspring), size_t taxon_t::*>::value, "emp::Taxon::num_offspring changed");
+        static_assert(std::is_same<decltype(&TaxonLink::total_offspring), size_t taxon_t::*>::value, "emp::Taxon::total_offspring changed");
+        static_assert(std::is_same<decltype(&TaxonLink::depth), size_t taxon_t::*>::value, "emp::Taxon::depth changed");
+
+        tax.*(&TaxonLink::num_orgs) = orgs;
+        tax.*(&TaxonLink::tot_orgs) = tot;
+        tax.*(&TaxonLink::num_offspring) = off;
+        tax.*(&TaxonLink::total_offspring) = tot_off;
+        tax.*(&TaxonLink::depth) = dep;
+
+        return tax.GetNumOrgs() == orgs && tax.GetTotOrgs() == tot && tax.GetNumOff() == off
+            && tax.GetTotalOffspring() == tot_off && tax.GetDepth() == dep;
+      }
+    };
+
+    // parent id written for root taxa
+    static constexpr uint64_t NO_TAXON = std::numeric_limits<uint64_t>::max();
+
+    // extra branch length (beyond 1) collapsed onto each taxon
+    branch_t branch;
+    // ancestor taxa removed so far
+    size_t compacted = 0;
+};
+
+///< tree compaction
+
+template <typename ORG, typename ORG_INFO, typename DATA_STRUCT>
+size_t CompactSystematics<ORG, ORG_INFO, DATA_STRUCT>::Compact()
+{
+  // collect candidates first, the ancestor set is altered as we go
+  emp::vector<taxon_p> chain;
+  for(auto tax : this->ancestor_taxa)
+  {
+    if(tax->GetNumOff() == 1 && tax->GetParent()) {chain.push_back(tax);}
+  }
+
+  for(auto tax : chain)
+  {
+    // quick checks
+    emp_assert(tax->GetNumOrgs() == 0); emp_assert(tax->GetNumOff() == 1);
+
+    // offspring and parent are read now, earlier removals may have relinked them
+    taxon_p parent = tax->GetParent();
+    taxon_p child = *(tax->GetOffspring().begin());
+    emp_assert(parent); emp_assert(child);
+
+    // child edge now spans both edges
+    branch[child->GetID()] = BranchLength(child) + BranchLength(tax) - 1;
+    branch.erase(tax->GetID());
+
+    // move child up to the grandparent, extant offspring totals stay the same
+    parent->RemoveOffspring(tax);
+    parent->AddOffspring(child);
+    parent->RemoveTotalOffspring();
+    TaxonLink::Relink(*child, parent);
+
+    // free the removed ancestor
+    this->ancestor_taxa.erase(tax);
+    tax.Delete();
+  }
+
+  // cached mrca may have been freed
+  this->mrca = nullptr;
+
+  // drop branch lengths of taxa pruned since the last pass
+  branch_t live;
+  for(const auto & set : {&this->active_taxa, &this->ancestor_taxa})
+  {
+    for(auto tax : *set)
+    {
+      const auto it = branch.find(tax->GetID());
+      if(it != branch.end()) {live.insert(*it);}
+    }
+  }
+  branch.swap(live);
+
+  compacted += chain.size();
+  return chain.size();
+}
+
+template <typename ORG, typename ORG_INFO, typename DATA_STRUCT>
+size_t CompactSystematics<ORG, ORG_INFO, DATA_STRUCT>::BranchLength(taxon_p tax) const
+{
+  const auto it = branch.find(tax->GetID());
+  if(it == branch.end()) {return 1;}
+
+  return 1 + it->second;
+}
+
+///< branch length aware phylodiversity
+
+template <typename ORG, typename ORG_INFO, typename DATA_STRUCT>
+double CompactSystematics<ORG, ORG_INFO, DATA_STRUCT>::GetCompactPhylogeneticDiversity() const
+{
+  // every non-root node contributes its edge, same as the node count minus one
+  double pd = static_cast<double>(this->active_taxa.size() + this->ancestor_taxa.size()) - 1.0;
+
+  for(const auto & set : {&this->active_taxa, &this->ancestor_taxa})
+  {
+    for(auto tax : *set)
+    {
+      const auto it = branch.find(tax->GetID());
+      if(it != branch.end()) {pd += static_cast<double>(it->second);}
+    }
+  }
+
+  return pd;
+}
+
+template <typename ORG, typename ORG_INFO, typename DATA_STRUCT>
+emp::vector<double> CompactSystematics<ORG, ORG_INFO, DATA_STRUCT>::GetCompactPairwiseDistances() const
+{
+  emp::vector<taxon_p> active(this->active_taxa.begin(), this->active_taxa.end());
+  emp::vector<double> dist;
+
+  for(size_t i = 0; i < active.size(); ++i)
+  {
+    // distance from taxon i to each of its ancestors
+    std::unordered_map<size_t, double> up;
+    double acc = 0.0;
+    for(taxon_p tax = active[i]; tax; tax = tax->GetParent())
+    {
+      up[tax->GetID()] = acc;
+      acc += static_cast<double>(BranchLength(tax));
+    }
+
+    // walk each other taxon up until we reach a shared ancestor
+    for(size_t j = i + 1; j < active.size(); ++j)
+    {
+      acc = 0.0;
+      for(taxon_p tax = active[j]; tax; tax = tax->GetParent())
+      {
+        const auto it = up.find(tax->GetID());
+        if(it != up.end()) {dist.push_back(acc + it->second); break;}
+        acc += static_cast<double>(BranchLength(tax));
+      }
+    }
+  }
+
+  return dist;
+}
+
+///< checkpointing
+
+template <typename ORG, typename ORG_INFO, typename DATA_STRUCT>
+void CompactSystematics<ORG, ORG_INFO, DATA_STRUCT>::Save(CheckpointWriter & out) const
+{
+  // manager counters
+  out.Put<uint64_t>(this->org_count); out.Put<uint64_t>(this->total_depth); out.Put<uint64_t>(this->num_roots);
+  out.Put<uint64_t>(this->next_id); out.Put<uint64_t>(this->curr_update); out.Put<uint64_t>(compacted);
+
+  // taxa, parents before offspring
+  emp::vector<taxon_p> taxa = GetTaxa();
+  std::sort(taxa.begin(), taxa.end(), [](const taxon_p & a, const taxon_p & b) {return a->GetID() < b->GetID();});
+
+  out.Put<uint64_t>(taxa.size());
+  for(auto tax : taxa)
+  {
+    const uint64_t set = this->active_taxa.count(tax) ? 0 : (this->ancestor_taxa.count(tax) ? 1 : 2);
+    const auto it = branch.find(tax->GetID());
+
+    out.Put<uint64_t>(tax->GetID()); out.Put<uint64_t>(tax->GetParent() ? tax->GetParent()->GetID() : NO_TAXON);
+    out.Put<uint64_t>(set);
+    out.Put<double>(tax->GetOriginationTime()); out.Put<double>(tax->GetDestructionTime());
+    out.Put<uint64_t>(tax->GetNumOrgs()); out.Put<uint64_t>(tax->GetTotOrgs());
+    out.Put<uint64_t>(tax->GetNumOff()); out.Put<uint64_t>(tax->GetTotalOffspring());
+    out.Put<uint64_t>(tax->GetDepth()); out.Put<uint64_t>(it == branch.end() ? 0 : it->second);
+    out.PutVec(tax->GetInfo());
+    tax->GetData().Save(out);
+  }
+
+  // taxon at each population position
+  out.Put<uint64_t>(this->taxon_locations.size());
+  for(auto tax : this->taxon_locations) {out.Put<uint64_t>(tax ? tax->GetID() : NO_TAXON);}
+}
+
+template <typename ORG, typename ORG_INFO, typename DATA_STRUCT>
+bool CompactSystematics<ORG, ORG_INFO, DATA_STRUCT>::Load(CheckpointReader & in)
+{
+  emp_assert(this->active_taxa.size() == 0); emp_assert(this->ancestor_taxa.size() == 0);
+
+  this->org_count = in.Get<uint64_t>(); this->total_depth = in.Get<uint64_t>(); this->num_roots = in.Get<uint64_t>();
+  this->next_id = in.Get<uint64_t>();
+  // saved inside the update signal, before the world advances the systematics
+  this->curr_update = in.Get<uint64_t>();
+  compacted = in.Get<uint64_t>();
+  // recomputed on request
+  this->max_depth = -1;
+  this->mrca = nullptr;
+
+  // counters are set once every offspring has been linked (linking bumps them)
+  struct Counts {taxon_p tax; uint64_t orgs, tot, off, tot_off, dep;};
+  emp::vector<Counts> counts;
+
+  std::unordered_map<uint64_t, taxon_p> by_id;
+  const uint64_t cnt = in.Get<uint64_t>();
+  for(uint64_t t = 0; t < cnt && in.Ok(); ++t)
+  {
+    const uint64_t id = in.Get<uint64_t>(), pid = in.Get<uint64_t>(), set = in.Get<uint64_t>();
+    const double origin = in.Get<double>(), destruction = in.Get<double>();
+    const uint64_t orgs = in.Get<uint64_t>(), tot = in.Get<uint64_t>(), off = in.Get<uint64_t>(), tot_off = in.Get<uint64_t>();
+    const uint64_t dep = in.Get<uint64_t>(), extra = in.Get<uint64_t>();
+    const ORG_INFO info = in.GetVec<typename ORG_INFO::value_type>();
+
+    // parents always carry smaller ids
+    taxon_p parent = nullptr;
+    if(pid != NO_TAXON)
+    {
+      const auto it = by_id.find(pid);
+      if(it == by_id.end()) {std::cerr << "CHECKPOINT: TAXON " << id << " MISSING PARENT " << pid << std::endl; return false;}
+      parent = it->second;
+    }
+
+    taxon_p tax = emp::NewPtr<taxon_t>(id, info, parent);
+    if(parent) {parent->AddOffspring(tax);}
+    tax->GetData().Load(in);
+    tax->SetOriginationTime(origin); tax->SetDestructionTime(destruction);
+    by_id[id] = tax;
+
+    if(set == 0) {this->active_taxa.insert(tax);}
+    else if(set == 1) {this->ancestor_taxa.insert(tax);}
+    else {this->outside_taxa.insert(tax);}
+    if(extra) {branch[id] = extra;}
+    counts.push_back({tax, orgs, tot, off, tot_off, dep});
+  }
+  if(!in.Ok()) {return false;}
+
+  for(const auto & c : counts)
+  {
+    if(!TaxonLink::Restore(*c.tax, c.orgs, c.tot, c.off, c.tot_off, c.dep))
+    {
+      std::cerr << "CHECKPOINT: TAXON " << c.tax->GetID() << " COUNTERS DID NOT READ BACK (emp::Taxon layout changed?)" << std::endl;
+      return false;
+    }
+  }
+
+  const uint64_t positions = in.Get<uint64_t>();
+  this->taxon_locations.assign(positions, nullptr);
+  for(uint64_t i = 0; i < positions; ++i)
+  {
+    const uint64_t id = in.Get<uint64_t>();
+    if(id == NO_TAXON) {continue;}
+    const auto it = by_id.find(id);
+    if(it == by_id.end()) {std::cerr << "CHECKPOINT: POSITION " << i << " HOLDS UNKNOWN TAXON " << id << std::endl; return false;}
+    this->taxon_locations[i] = it->second;
+  }
+  this->next_taxon_locations = this->taxon_locations;
+
+  return in.Ok();
+}
+
+#endif
@@ -0,0 +1,87 @@
+/// Gene storage type and rounding of gene values to float32 or 16-bit fixed point scaled to the target
+///
+/// gene_t is what Org, Diagnostic, Selection and MutationKernel store genes and scores in: double by default,
+/// float32 when built with GENE_FLOAT=1 (DIA_GENE_FLOAT). Aggregates and transformed fitness stay double.
+/// GeneCodec (GENE_ROUNDING) only emulates a narrower type on top of gene_t, so its effect on evolutionary
+/// outcomes can be checked (DataTools/Checker/precision-checker.py); 16-bit fixed point has no storage type.
+
+#ifndef DIA_PRECISION_H
+#define DIA_PRECISION_H
+
+///< standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+
+///< constant vars
+constexpr double FIXED16_MAX = 65535.0;
+
+// type genes and per objective scores are stored in (Org, Diagnostic, Selection, MutationKernel)
+// float halves genome & score matrix memory and bandwidth and doubles the values per SIMD register
+#ifdef DIA_GENE_FLOAT
+using gene_t = float;
+constexpr const char * GENE_TYPE_NAME = "float32";
+#else
+using gene_t = double;
+constexpr const char * GENE_TYPE_NAME = "float64";
+#endif
+
+class GeneCodec
+{
+  // object types for consistency between working class
+  public:
+    // precision genes are rounded to
+    enum Mode : size_t {DOUBLE = 0, FLOAT = 1, FIXED16 = 2};
+
+  public:
+
+    GeneCodec(const size_t _mode = DOUBLE, const double _target = 1.0) : mode(static_cast<Mode>(_mode)), target(_target)
+    {
+      emp_assert(_mode <= FIXED16); emp_assert(0.0 < target);
+    }
+
+    // are genes being rounded?
+    bool IsActive() const {return mode != DOUBLE;}
+
+    /**
+     * Round function:
+     *
+     * Nearest value representable in the current precision.
+     * Fixed point covers [0, target] in 65535 even steps, values outside are clamped.
+     *
+     * @param x gene value.
+     *
+     * @return x rounded to the current precision (exact in double).
+     */
+    double Round(const double x) const
+    {
+      switch (mode)
+      {
+        case FLOAT:
+          return static_cast<double>(static_cast<float>(x));
+
+        case FIXED16:
+          return target * static_cast<double>(Encode16(x)) / FIXED16_MAX;
+
+        default:
+          return x;
+      }
+    }
+
+    // fixed point code of x
+    uint16_t Encode16(const double x) const
+    {
+      return static_cast<uint16_t>(std::lround(std::clamp(x, 0.0, target) / target * FIXED16_MAX));
+    }
+
+  private:
+    // precision genes are rounded to
+    Mode mode;
+    // upper end of the fixed point range
+    double target;
+};
+
+#endif
@@ -4,17 +4,22 @@
 
 ///< standard headers
 #include <algorithm>
+#include <array>
+#include <functional>
 
 ///< empirical headers
 #include "emp/base/vector.hpp"
 
+///< experiment headers
+#include "precision.h"
+
 class Diagnostic
 {
   public:
     //typename for target vector
     using target_t = emp::vector<double>;
-    using score_t = emp::vector<double>;
-    using genome_t = emp::vector<double>;
+    using score_t = emp::vector<gene_t>;
+    using genome_t = emp::vector<gene_t>;
     using opti_t = emp::vector<bool>;
 
   public:
@@ -141,6 +146,60 @@ class Diagnostic
     bool cred_set = false;
 };
 
+/**
+ * Fixed Diagnostic:
+ *
+ * Same diagnostics as above with the objective count M known at compile time.
+ * Genomes are read in place and scores/optimal flags are written to std::arrays, so nothing is allocated.
+ * Every position shares one target value (as in the experiments).
+ */
+template <size_t M>
+class FixedDiagnostic
+{
+  public:
+    using score_t = std::array<gene_t, M>;
+    using opti_t = std::array<bool, M>;
+    // one of the scoring kernels below
+    using kernel_t = void (FixedDiagnostic::*)(const gene_t *, score_t &) const;
+
+  public:
+
+    FixedDiagnostic(const double t_, const double c) : target(t_), max_cred(c) {;}
+
+    ///< Functions that deal with diagnostic problem scoring (see Diagnostic)
+
+    void Exploration(const gene_t * g, score_t & score) const;
+
+    void Exploitation(const gene_t * g, score_t & score) const;
+
+    void WeakEcology(const gene_t * g, score_t & score) const;
+
+    void StrongEcology(const gene_t * g, score_t & score) const;
+
+    void StructExploitation(const gene_t * g, score_t & score) const;
+
+    ///< Functions that deal with interpretation of score vectors
+
+    /**
+     * Optimized Vector:
+     *
+     * Same as Diagnostic::OptimizedVector.
+     *
+     * @param g Genome from organism being evaluated.
+     * @param acc This value is the accuracy % needed to be considered optimized
+     * @param optimize flags to fill.
+     *
+     * @return number of optimized traits.
+    */
+    size_t OptimizedVector(const gene_t * g, const double acc, opti_t & optimize) const;
+
+  private:
+    // target value at every position
+    double target;
+    // maximum credit allowed for error
+    double max_cred;
+};
+
 ///< diagnostic problem implementations
 
 Diagnostic::score_t Diagnostic::Exploration(const genome_t & g)
@@ -276,4 +335,62 @@ Diagnostic::opti_t Diagnostic::OptimizedVector(const genome_t & g, const double
   return optimize;
 }
 
+///< fixed size diagnostic implementations
+
+template <size_t M>
+void FixedDiagnostic<M>::Exploration(const gene_t * g, score_t & score) const
+{
+  // find max value position and where order breaks after it
+  const gene_t * opti_it = std::max_element(g, g + M);
+  const size_t opti = std::distance(g, opti_it);
+  const size_t sort = std::distance(g, std::is_sorted_until(opti_it, g + M, std::greater<>()));
+
+  for(size_t i = 0; i < M; ++i) {score[i] = (opti <= i && i < sort) ? g[i] : max_cred;}
+}
+
+template <size_t M>
+void FixedDiagnostic<M>::Exploitation(const gene_t * g, score_t & score) const
+{
+  std::copy(g, g + M, score.begin());
+}
+
+template <size_t M>
+void FixedDiagnostic<M>::WeakEcology(const gene_t * g, score_t & score) const
+{
+  const gene_t max = *std::max_element(g, g + M);
+  for(size_t i = 0; i < M; ++i) {score[i] = (g[i] == max) ? max : 0.0;}
+}
+
+template <size_t M>
+void FixedDiagnostic<M>::StrongEcology(const gene_t * g, score_t & score) const
+{
+  const gene_t max = *std::max_element(g, g + M);
+  for(size_t i = 0; i < M; ++i) {score[i] = (g[i] == max) ? max : max - g[i];}
+}
+
+template <size_t M>
+void FixedDiagnostic<M>::StructExploitation(const gene_t * g, score_t & score) const
+{
+  // everything after descending order breaks gets max credit
+  const size_t cutoff = std::distance(g, std::is_sorted_until(g, g + M, std::greater<>()));
+  for(size_t i = 0; i < M; ++i) {score[i] = (i < cutoff) ? g[i] : max_cred;}
+}
+
+template <size_t M>
+size_t FixedDiagnostic<M>::OptimizedVector(const gene_t * g, const double acc, opti_t & optimize) const
+{
+  // quick checks
+  emp_assert(0.0 < acc); emp_assert(acc <= 1.0);
+
+  const double bar = acc * target;
+  size_t cnt = 0;
+  for(size_t i = 0; i < M; ++i)
+  {
+    optimize[i] = (bar <= g[i]);
+    cnt += optimize[i];
+  }
+
+  return cnt;
+}
+
 #endif
\ No newline at end of file
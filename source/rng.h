@@ -0,0 +1,141 @@
+/// Counter-based random numbers (Philox4x32-10) keyed by seed, generation, index and purpose
+
+#ifndef DIA_RNG_H
+#define DIA_RNG_H
+
+///< standard headers
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+
+///< constant vars
+constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+constexpr size_t PHILOX_ROUNDS = 10;
+
+// what a stream is drawn for, so two uses of the same (generation, index) never share numbers
+enum class RngPurpose : uint32_t {MUTATION = 1, SELECTION = 2, COHORT = 3, ECOEA = 4, SAMPLE = 5, CHECKPOINT = 6};
+
+class Philox
+{
+  public:
+    using block_t = std::array<uint32_t, 4>;
+    using key_t = std::array<uint32_t, 2>;
+
+    /**
+     * Block function:
+     *
+     * Philox4x32-10 bijection: the same counter and key always give the same four words.
+     *
+     * @param ctr 128-bit counter.
+     * @param key 64-bit key.
+     *
+     * @return four random 32-bit words.
+     */
+    static block_t Block(block_t ctr, key_t key)
+    {
+      for(size_t r = 0; r < PHILOX_ROUNDS; ++r)
+      {
+        const uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * ctr[0];
+        const uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * ctr[2];
+
+        ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+               static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+
+        key[0] += PHILOX_W0; key[1] += PHILOX_W1;
+      }
+
+      return ctr;
+    }
+};
+
+class CounterRandom
+{
+  public:
+
+    /**
+     * Stream keyed by (seed, generation, index, purpose):
+     *
+     * Streams with different keys are independent, and re-creating a stream replays it exactly.
+     * No state is shared, so streams can be drawn from on any thread in any order.
+     */
+    CounterRandom(const uint64_t seed, const uint64_t gen, const uint64_t idx, const RngPurpose purpose)
+      : key({static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}),
+        gen(static_cast<uint32_t>(gen)), idx(static_cast<uint32_t>(idx)), purpose(static_cast<uint32_t>(purpose))
+    {
+      emp_assert(gen <= UINT32_MAX); emp_assert(idx <= UINT32_MAX);
+    }
+
+    ///< same interface as the parts of emp::Random the experiment uses
+
+    // uniform 32-bit word
+    uint32_t GetUInt()
+    {
+      if(used == 4) {Refill();}
+      return block[used++];
+    }
+
+    // uniform in [0, max)
+    uint32_t GetUInt(const uint32_t max) {return static_cast<uint32_t>(GetDouble() * max);}
+
+    // uniform in [min, max)
+    size_t GetUInt(const size_t min, const size_t max) {return min + static_cast<size_t>(GetDouble() * (max - min));}
+
+    // uniform in [0, 1) with 53 random bits
+    double GetDouble()
+    {
+      const uint64_t hi = GetUInt() >> 5;
+      const uint64_t lo = GetUInt() >> 6;
+      return (static_cast<double>(hi) * 67108864.0 + static_cast<double>(lo)) / 9007199254740992.0;
+    }
+
+    // uniform in [min, max)
+    double GetDouble(const double min, const double max) {return min + GetDouble() * (max - min);}
+
+    // true with probability p
+    bool P(const double p) {return GetDouble() < p;}
+
+    // normal deviate (Box-Muller, second deviate kept for the next call)
+    double GetRandNormal(const double mean = 0.0, const double std = 1.0)
+    {
+      if(spare_ok) {spare_ok = false; return mean + std * spare;}
+
+      const double u1 = 1.0 - GetDouble();
+      const double u2 = GetDouble();
+      const double r = std::sqrt(-2.0 * std::log(u1));
+      const double theta = 6.283185307179586476925286766559 * u2;
+      spare = r * std::sin(theta); spare_ok = true;
+      return mean + std * r * std::cos(theta);
+    }
+
+  private:
+    // next block of the stream
+    void Refill()
+    {
+      block = Philox::Block({draw, purpose, idx, gen}, key);
+      ++draw; used = 0;
+    }
+
+  private:
+    // seed split over both key words
+    Philox::key_t key;
+    // stream coordinates (counter words 1-3)
+    uint32_t gen, idx, purpose;
+    // blocks drawn so far (counter word 0)
+    uint32_t draw = 0;
+
+    // current block and words used from it
+    Philox::block_t block = {0, 0, 0, 0};
+    size_t used = 4;
+
+    // second Box-Muller deviate
+    double spare = 0.0;
+    bool spare_ok = false;
+};
+
+#endif
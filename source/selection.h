@@ -10,6 +10,7 @@
 #include <map>
 #include <utility>
 #include <cmath>
+#include <cstdint>
 #include <numeric>
 
 ///< empirical headers
@@ -17,6 +18,10 @@
 #include "emp/math/Random.hpp"
 #include "emp/math/random_utils.hpp"
 
+///< experiment headers
+#include "precision.h"
+#include "rng.h"
+
 ///< constant vars
 constexpr size_t DRIFT_SIZE = 1;
 constexpr double ERROR_VALD = -1.0;
@@ -27,12 +32,16 @@ class Selection
   public:
     // vector of any ids
     using ids_t = emp::vector<size_t>;
-    // vector type of org score
+    // vector type of org score (one value per org: aggregates, transformed fitness)
     using score_t = emp::vector<double>;
+    // vector of per objective scores or genes (gene_t, see precision.h)
+    using row_t = emp::vector<gene_t>;
     // matrix type of org with multiple scores
-    using fmatrix_t = emp::vector<score_t>;
+    using fmatrix_t = emp::vector<row_t>;
+    // matrix of pairwise distances
+    using dmatrix_t = emp::vector<score_t>;
     // vector holding population genomes
-    using gmatrix_t = emp::vector<emp::vector<double>>;
+    using gmatrix_t = emp::vector<row_t>;
     // map holding population id groupings by fitness (keys in decending order)
     using fitgp_t = std::map<double, ids_t, std::greater<double>>;
     // sorted score vector w/ position id and score
@@ -42,11 +51,50 @@ class Selection
     // vector of vector position ids that represent cohort assignment
     using cohort_t = emp::vector<ids_t>;
 
+    // distinct score rows left after a lexicase reduction, with the solutions behind each row
+    struct LexPool
+    {
+      // traits per row
+      size_t M = 0;
+      // distinct score rows (row major, Size() x M)
+      row_t rows;
+      // solutions sharing row u: members[start[u]] ... members[start[u+1] - 1]
+      ids_t members;
+      ids_t start = {0};
+
+      // number of distinct rows
+      size_t Size() const {return start.size() - 1;}
+      // number of solutions sharing row u
+      size_t Count(const size_t u) const {return start[u + 1] - start[u];}
+      // score of row u on testcase t
+      double Score(const size_t u, const size_t t) const {return rows[u * M + t];}
+    };
+
 
   public:
 
     Selection(emp::Ptr<emp::Random> rng = nullptr) : random(rng) {emp_assert(rng);}
 
+    ///< random streams
+
+    // draw from one counter based stream per selection event, keyed by (seed, generation, event), instead of the shared generator
+    void SetCounterStreams(const uint64_t seed) {counter = true; run_seed = seed;}
+    bool HasCounterStreams() const {return counter;}
+
+    /**
+     * Set Event function:
+     *
+     * Events (calls to a drawing kernel) are numbered in call order from here, so the
+     * i-th parent picked in a generation draws from stream i wherever it is picked.
+     *
+     * @param gen generation the events belong to.
+     * @param event number of the next event.
+     */
+    void SetEvent(const size_t gen, const size_t event = 0) {stream_gen = gen; stream_event = event;}
+
+    // S of M testcases for down-sampled lexicase, drawn as one event
+    ids_t DrawCases(const size_t M, const size_t S) {NextStream(); return Choose(M, S);}
+
 
     ///< helper functions
 
@@ -54,10 +102,10 @@ class Selection
     double Distance(double a, double b) {return std::abs(a - b);}
 
     // p-norm function between two vector subtractions and the exponent for p
-    double Pnorm(const score_t & x, const score_t & y, const double exp);
+    double Pnorm(const row_t & x, const row_t & y, const double exp);
 
     // similarity matrix generator
-    fmatrix_t SimilarityMatrix(const gmatrix_t & genome, const double exp);
+    dmatrix_t SimilarityMatrix(const gmatrix_t & genome, const double exp);
 
     // sanity check for novelty lexicase
     bool SizeCheck(const fmatrix_t & matrix, const size_t M)
@@ -141,7 +189,7 @@ class Selection
      *
      * @return Vector with parent id's that are selected.
      */
-    score_t FitnessSharing(const fmatrix_t & dmat, const score_t & score, const double alph, const double sig);
+    score_t FitnessSharing(const dmatrix_t & dmat, const score_t & score, const double alph, const double sig);
 
     /**
      * Fitness Sharing: Sharing Function
@@ -218,6 +266,24 @@ class Selection
      */
     size_t Tournament(const size_t t, const score_t & score);
 
+    /**
+     * Batched Tournament Selector:
+     *
+     * This function holds 'n' tournaments of 't' solutions drawn with replacement.
+     * All n * t entrants are drawn first, in one pass, into a buffer kept between calls,
+     * then each tournament is a tight max over its slice of the buffer.
+     * In the event of ties, the entrant drawn first wins (entrants are drawn uniformly, so this is a random tie break).
+     *
+     * Draws are made in the same order as calling GetUInt(score.size()) t times per tournament.
+     *
+     * @param n Number of tournaments.
+     * @param t Tournament size.
+     * @param score Vector holding the population score.
+     *
+     * @return Parent ids of the n tournament winners.
+     */
+    ids_t TournamentBatch(const size_t n, const size_t t, const score_t & score);
+
     /**
      * Drift Selector:
      *
@@ -247,6 +313,40 @@ class Selection
      */
     size_t EpsiLexicase(const fmatrix_t & mscore, const double epsi, const size_t M);
 
+    /**
+     * Lexicase Reduction:
+     *
+     * Run once per generation, before the selection events.
+     * Solutions with identical score vectors are merged into one row (remembering every solution behind it),
+     * so events only do work per distinct phenotype.
+     * With dominance, rows that can never win an epsilon lexicase event are dropped as well: row a goes if some row b
+     * is at least as good on every testcase and better by more than epsi on one of them.
+     * Whenever a survives a testcase b does too, and the testcase where b is ahead by more than epsi
+     * is always reached while both are left, so a can never be picked.
+     *
+     * @param mscore Matrix of solution fitnesses (mscore.size => # of orgs).
+     * @param epsi Epsilon threshold value.
+     * @param M Number of traits we are expecting.
+     * @param dominance Also drop dominated rows (costs a pass over every pair of distinct rows).
+     *
+     * @return Pool of distinct (non dominated) rows.
+     */
+    LexPool LexReduce(const fmatrix_t & mscore, const double epsi, const size_t M, const bool dominance = true);
+
+    /**
+     * Epsilon Lexicase Selector (reduced pool):
+     *
+     * Epsilon lexicase over the rows of a LexPool. When several rows are left at the end,
+     * a row is picked in proportion to the solutions behind it and then a solution uniformly within it,
+     * which gives every solution the same chance of being selected as EpsiLexicase on the full matrix.
+     *
+     * @param pool Rows from LexReduce.
+     * @param epsi Epsilon threshold value (the one used to build pool).
+     *
+     * @return A single winning solution id.
+     */
+    size_t EpsiLexicase(const LexPool & pool, const double epsi);
+
     /**
      * Down Sampled Epsilon Lexicase Selector:
      *
@@ -264,6 +364,33 @@ class Selection
      */
     size_t DSELexicase(const fmatrix_t & mscore, const double epsi, const ids_t & t_cases);
 
+    /**
+     * Down Sampled Matrix:
+     *
+     * This function gathers the sampled testcase columns once per generation,
+     * into a dense column-major matrix (column k holds every solution's score on t_cases[k]).
+     *
+     * @param mscore Matrix of solution fitnesses (mscore.size => # of orgs).
+     * @param t_cases vector of sampled testcases.
+     *
+     * @return Column-major N x S matrix, S = t_cases.size().
+     */
+    row_t DownSample(const fmatrix_t & mscore, const ids_t & t_cases);
+
+    /**
+     * Down Sampled Epsilon Lexicase Selector (dense):
+     *
+     * Same selection, and same random number draws, as DSELexicase above,
+     * run on the matrix from DownSample so every testcase reads one contiguous column.
+     *
+     * @param dmat Column-major N x S matrix of the sampled testcases.
+     * @param N Number of solutions.
+     * @param epsi Epsilon threshold value.
+     *
+     * @return A single winning solution id.
+     */
+    size_t DSELexicase(const row_t & dmat, const size_t N, const double epsi);
+
     /**
      * Cohort Epsilon Lexicase Selector:
      *
@@ -282,10 +409,70 @@ class Selection
      */
     size_t CELexicase(const fmatrix_t & mscore, const double epsi, const ids_t & pop_coh, const ids_t & test_coh);
 
+    /**
+     * Dense Epsilon Lexicase Selector:
+     *
+     * Epsilon lexicase on a dense column-major matrix (column k holds every solution's score on testcase k),
+     * e.g. one cohort's solutions x that cohort's testcases.
+     * Draws only from the generator passed in, never from the shared one,
+     * so independent matrices can be processed on different threads.
+     *
+     * @param dmat Column-major N x S matrix.
+     * @param N Number of solutions.
+     * @param S Number of testcases.
+     * @param epsi Epsilon threshold value.
+     * @param rng Random number generator (emp::Random or CounterRandom).
+     *
+     * @return Row of the winning solution in dmat.
+     */
+    template <typename RNG>
+    size_t DenseLexicase(const gene_t * dmat, const size_t N, const size_t S, const double epsi, RNG & rng);
+
+  private:
+
+    // start the next event's stream (counter streams only)
+    void NextStream()
+    {
+      if(counter) {stream = CounterRandom(run_seed, stream_gen, stream_event++, RngPurpose::SELECTION);}
+    }
+
+    // uniform in [0, max) from the shared generator or the event stream
+    template <typename T>
+    size_t RandUInt(const T max) {return counter ? stream.GetUInt(static_cast<uint32_t>(max)) : random->GetUInt(max);}
+
+    // emp::Shuffle on the shared generator, Fisher-Yates on the event stream
+    void Shuffle(ids_t & v)
+    {
+      if(!counter) {emp::Shuffle(*random, v); return;}
+      for(size_t i = 0; i + 1 < v.size(); ++i) {std::swap(v[i], v[stream.GetUInt(i, v.size())]);}
+    }
+
+    // emp::Choose on the shared generator, K distinct ids out of N from the event stream
+    ids_t Choose(const size_t N, const size_t K)
+    {
+      if(!counter) {return emp::Choose(*random, N, K);}
+      emp_assert(K <= N);
+      ids_t ids(N);
+      std::iota(ids.begin(), ids.end(), 0);
+      for(size_t i = 0; i < K; ++i) {std::swap(ids[i], ids[stream.GetUInt(i, N)]);}
+      ids.resize(K);
+      return ids;
+    }
+
   private:
 
     // random pointer from world.h
     emp::Ptr<emp::Random> random;
+
+    // counter based streams (RNG_MODE 1) and the event being drawn for
+    bool counter = false;
+    uint64_t run_seed = 0;
+    size_t stream_gen = 0;
+    size_t stream_event = 0;
+    CounterRandom stream = CounterRandom(0, 0, 0, RngPurpose::SELECTION);
+
+    // entrants of batched tournaments
+    ids_t tour_buf;
 };
 
 ///< population structure
@@ -378,6 +565,8 @@ Selection::fitgp_t Selection::FitnessGroup(const score_t & score)
 
 Selection::cohort_t Selection::CohortGeneration(const size_t N, const double P)
 {
+  NextStream();
+
   // quick checks
   emp_assert(0 < N); emp_assert(0 < P);
 
@@ -397,7 +586,7 @@ Selection::cohort_t Selection::CohortGeneration(const size_t N, const double P)
   // initialize position ids and shuffle
   ids_t pop(N);
   std::iota(pop.begin(), pop.end(), 0);
-  emp::Shuffle(*random, pop);
+  Shuffle(pop);
 
   // distrubute the shuffled population ids into the cohorts
   emp_assert(cohorts.size() == coh_num);
@@ -420,7 +609,7 @@ Selection::cohort_t Selection::CohortGeneration(const size_t N, const double P)
 
 ///< fitness transformation >///
 
-Selection::score_t Selection::FitnessSharing(const fmatrix_t & dmat, const score_t & score, const double alph, const double sig)
+Selection::score_t Selection::FitnessSharing(const dmatrix_t & dmat, const score_t & score, const double alph, const double sig)
 {
   // quick checks
   emp_assert(dmat.size() == score.size()); emp_assert(0 <= alph); emp_assert(0 <= sig);
@@ -559,6 +748,8 @@ Selection::fmatrix_t Selection::LexicaseNoveltyFit(const fmatrix_t & mscore, con
 
 Selection::ids_t Selection::MLSelect(const size_t mu, const size_t lambda, const fitgp_t & group)
 {
+  NextStream();
+
   // quick checks
   emp_assert(0 < mu); emp_assert(0 < lambda);
   emp_assert(mu <= lambda); emp_assert(0 < group.size());
@@ -585,7 +776,7 @@ Selection::ids_t Selection::MLSelect(const size_t mu, const size_t lambda, const
   for(auto & g : group)
   {
     auto gt = g.second;
-    emp::Shuffle(*random, gt);
+    Shuffle(gt);
     for(auto id : gt)
     {
       topmu.push_back(id);
@@ -610,12 +801,14 @@ Selection::ids_t Selection::MLSelect(const size_t mu, const size_t lambda, const
 
 size_t Selection::Tournament(const size_t t, const score_t & score)
 {
+  NextStream();
+
   // quick checks
   emp_assert(0 < t); emp_assert(0 < score.size());
   emp_assert(t <= score.size());
 
   // get tournament ids
-  emp::vector<size_t> tour = emp::Choose(*random, score.size(), t);
+  emp::vector<size_t> tour = Choose(score.size(), t);
 
   // store all scores for the tournament
   emp::vector<double> subscore(t);
@@ -626,19 +819,54 @@ size_t Selection::Tournament(const size_t t, const score_t & score)
   emp::vector<size_t> opt = group.begin()->second;
 
   //shuffle the vector with best fitness ids
-  emp::Shuffle(*random, opt);
+  Shuffle(opt);
   emp_assert(0 < opt.size());
 
   return tour[opt[0]];
 }
 
+Selection::ids_t Selection::TournamentBatch(const size_t n, const size_t t, const score_t & score)
+{
+  NextStream();
+
+  // quick checks
+  emp_assert(0 < t); emp_assert(0 < score.size());
+
+  // draw every entrant up front
+  const size_t N = score.size();
+  tour_buf.resize(n * t);
+  for(auto & id : tour_buf) {id = RandUInt(N);}
+
+  ids_t parent(n);
+  const size_t * entry = tour_buf.data();
+  const double * fit = score.data();
+
+  for(size_t T = 0; T < n; ++T, entry += t)
+  {
+    size_t best_id = entry[0];
+    double best_fit = fit[best_id];
+
+    for(size_t i = 1; i < t; ++i)
+    {
+      const double cur_fit = fit[entry[i]];
+      if(cur_fit > best_fit) {best_fit = cur_fit; best_id = entry[i];}
+    }
+
+    parent[T] = best_id;
+  }
+
+  return parent;
+}
+
 size_t Selection::Drift(const size_t size)
 {
+  NextStream();
+
   // quick checks
   emp_assert(size > 0);
 
   // return a random org id
-  auto win = emp::Choose(*random, size, DRIFT_SIZE);
+  auto win = Choose(size, DRIFT_SIZE);
   emp_assert(win.size() == DRIFT_SIZE);
 
   return win[0];
@@ -646,13 +874,15 @@ size_t Selection::Drift(const size_t size)
 
 size_t Selection::EpsiLexicase(const fmatrix_t & mscore, const double epsi, const size_t M)
 {
+  NextStream();
+
   // quick checks
   emp_assert(0 < mscore.size()); emp_assert(0 <= epsi); emp_assert(0 < M);
 
   // create vector of shuffled testcase ids
   ids_t test_id(M);
   std::iota(test_id.begin(), test_id.end(), 0);
-  emp::Shuffle(*random, test_id);
+  Shuffle(test_id);
 
   // vector to hold filterd elite solutions
   ids_t filter(mscore.size());
@@ -697,13 +927,15 @@ size_t Selection::EpsiLexicase(const fmatrix_t & mscore, const double epsi, cons
 
   // Get a random position from the remaining filtered solutions (may be one left too)
   emp_assert(0 < filter.size());
-  size_t wid = emp::Choose(*random, filter.size(), 1)[0];
+  size_t wid = Choose(filter.size(), 1)[0];
 
   return filter[wid];
 }
 
 size_t Selection::DSELexicase(const fmatrix_t & mscore, const double epsi, const ids_t & t_cases)
 {
+  NextStream();
+
   // quick checks
   emp_assert(0 < mscore.size()); emp_assert(0.0 <= epsi);
   emp_assert(0 < t_cases.size());
@@ -711,7 +943,7 @@ size_t Selection::DSELexicase(const fmatrix_t & mscore, const double epsi, const
   // create a vector of shuffled testcase ids
   ids_t test_id(t_cases.size());
   std::iota(test_id.begin(), test_id.end(), 0);
-  emp::Shuffle(*random, test_id);
+  Shuffle(test_id);
 
   // create vector to hold filtered elite solutions
   ids_t filter(mscore.size());
@@ -755,13 +987,261 @@ size_t Selection::DSELexicase(const fmatrix_t & mscore, const double epsi, const
 
   // Get a random position from the remaining filtered solutions (may be one left too)
   emp_assert(0 < filter.size());
-  size_t wid = emp::Choose(*random, filter.size(), 1)[0];
+  size_t wid = Choose(filter.size(), 1)[0];
 
   return filter[wid];
 }
 
+Selection::LexPool Selection::LexReduce(const fmatrix_t & mscore, const double epsi, const size_t M, const bool dominance)
+{
+  // quick checks
+  emp_assert(0 < mscore.size()); emp_assert(0 <= epsi); emp_assert(0 < M);
+
+  // order solutions by score vector so identical ones sit next to each other (ids ascending within)
+  ids_t order(mscore.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&mscore](const size_t a, const size_t b) {return mscore[a] < mscore[b];});
+
+  // distinct rows and where their solutions start in order
+  ids_t first;
+  for(size_t i = 0; i < order.size(); ++i)
+  {
+    emp_assert(mscore[order[i]].size() == M);
+    if(i == 0 || mscore[order[i]] != mscore[order[i - 1]]) {first.push_back(i);}
+  }
+  first.push_back(order.size());
+
+  // row b removes row a?
+  auto dominates = [this, &mscore, &order, &first, epsi, M](const size_t b, const size_t a)
+  {
+    const row_t & sb = mscore[order[first[b]]], & sa = mscore[order[first[a]]];
+    bool ahead = false;
+    for(size_t t = 0; t < M; ++t)
+    {
+      if(sb[t] < sa[t]) {return false;}
+      if(Distance(sb[t], sa[t]) > epsi) {ahead = true;}
+    }
+    return ahead;
+  };
+
+  LexPool pool;
+  pool.M = M;
+  const size_t U = first.size() - 1;
+  for(size_t a = 0; a < U; ++a)
+  {
+    bool keep = true;
+    for(size_t b = 0; dominance && b < U && keep; ++b) {if(b != a && dominates(b, a)) {keep = false;}}
+    if(!keep) {continue;}
+
+    const row_t & row = mscore[order[first[a]]];
+    pool.rows.insert(pool.rows.end(), row.begin(), row.end());
+    for(size_t i = first[a]; i < first[a + 1]; ++i) {pool.members.push_back(order[i]);}
+    pool.start.push_back(pool.members.size());
+  }
+
+  emp_assert(0 < pool.Size());
+  return pool;
+}
+
+size_t Selection::EpsiLexicase(const LexPool & pool, const double epsi)
+{
+  NextStream();
+
+  // quick checks
+  emp_assert(0 < pool.Size()); emp_assert(0 <= epsi);
+  const size_t M = pool.M;
+
+  // create vector of shuffled testcase ids
+  ids_t test_id(M);
+  std::iota(test_id.begin(), test_id.end(), 0);
+  Shuffle(test_id);
+
+  // vector to hold filterd elite rows
+  ids_t filter(pool.Size());
+  std::iota(filter.begin(), filter.end(), 0);
+
+  // iterate through testcases until we run out or have a single winning row
+  size_t tcnt = 0;
+  score_t scores;
+  ids_t temp_filter;
+  while(tcnt < M && filter.size() != 1)
+  {
+    // testcase we are randomly evaluating
+    const size_t testcase = test_id[tcnt];
+
+    // create vector of current filter rows
+    scores.resize(filter.size());
+    for(size_t i = 0; i < filter.size(); ++i) {scores[i] = pool.Score(filter[i], testcase);}
+
+    // group rows by performance in descending order
+    fitgp_t group = FitnessGroup(scores);
+
+    // update the filter vector with rows that are worthy
+    temp_filter.swap(filter);
+    filter.clear();
+    for(const auto & p : group)
+    {
+      if(Distance(group.begin()->first, p.first) <= epsi)
+      {
+        for(auto id : p.second) {filter.push_back(temp_filter[id]);}
+      }
+      else{break;}
+    }
+
+    ++tcnt;
+  }
+
+  // one draw over every solution behind the remaining rows: row by multiplicity, then uniform within
+  emp_assert(0 < filter.size());
+  size_t total = 0;
+  for(auto u : filter) {total += pool.Count(u);}
+
+  size_t wid = RandUInt(total);
+  for(auto u : filter)
+  {
+    if(wid < pool.Count(u)) {return pool.members[pool.start[u] + wid];}
+    wid -= pool.Count(u);
+  }
+
+  emp_assert(false);
+  return pool.members[0];
+}
+
+Selection::row_t Selection::DownSample(const fmatrix_t & mscore, const ids_t & t_cases)
+{
+  // quick checks
+  emp_assert(0 < mscore.size()); emp_assert(0 < t_cases.size());
+
+  const size_t N = mscore.size();
+  row_t dmat(N * t_cases.size());
+
+  for(size_t k = 0; k < t_cases.size(); ++k)
+  {
+    gene_t * col = dmat.data() + k * N;
+    for(size_t i = 0; i < N; ++i)
+    {
+      emp_assert(t_cases[k] < mscore[i].size());
+      col[i] = mscore[i][t_cases[k]];
+    }
+  }
+
+  return dmat;
+}
+
+size_t Selection::DSELexicase(const row_t & dmat, const size_t N, const double epsi)
+{
+  NextStream();
+
+  // quick checks
+  emp_assert(0 < N); emp_assert(0.0 <= epsi);
+  emp_assert(0 < dmat.size()); emp_assert(dmat.size() % N == 0);
+
+  // create a vector of shuffled testcase (column) ids
+  const size_t S = dmat.size() / N;
+  ids_t test_id(S);
+  std::iota(test_id.begin(), test_id.end(), 0);
+  Shuffle(test_id);
+
+  // create vector to hold filtered elite solutions
+  ids_t filter(N);
+  std::iota(filter.begin(), filter.end(), 0);
+
+  // iterate through testcases until we are out or have a winner
+  size_t tcnt = 0;
+  score_t scores;
+  ids_t temp_filter;
+  while(tcnt < S && filter.size() != 1)
+  {
+    // column of the testcase we are randomly evaluating
+    const gene_t * col = dmat.data() + test_id[tcnt] * N;
+
+    // create vector of current filter solutions
+    scores.resize(filter.size());
+    for(size_t i = 0; i < filter.size(); ++i) {scores[i] = col[filter[i]];}
+
+    // group org ids by performance in descending order
+    fitgp_t group = FitnessGroup(scores);
+
+    // update the filter vector with pop ids that are worthy
+    temp_filter.swap(filter);
+    filter.clear();
+    for(const auto & p : group)
+    {
+      if(Distance(group.begin()->first, p.first) <= epsi)
+      {
+        for(auto id : p.second)
+        {
+          filter.push_back(temp_filter[id]);
+        }
+      }
+      else{break;}
+    }
+
+    ++tcnt;
+  }
+
+  // Get a random position from the remaining filtered solutions (may be one left too)
+  emp_assert(0 < filter.size());
+  size_t wid = Choose(filter.size(), 1)[0];
+
+  return filter[wid];
+}
+
+template <typename RNG>
+size_t Selection::DenseLexicase(const gene_t * dmat, const size_t N, const size_t S, const double epsi, RNG & rng)
+{
+  // quick checks
+  emp_assert(dmat); emp_assert(0 < N); emp_assert(0 < S); emp_assert(0.0 <= epsi);
+
+  // create a vector of shuffled testcase (column) ids
+  ids_t test_id(S);
+  std::iota(test_id.begin(), test_id.end(), 0);
+  for(size_t i = 0; i + 1 < S; ++i) {std::swap(test_id[i], test_id[rng.GetUInt(i, S)]);}
+
+  // create vector to hold filtered elite solutions
+  ids_t filter(N);
+  std::iota(filter.begin(), filter.end(), 0);
+
+  // iterate through testcases until we are out or have a winner
+  size_t tcnt = 0;
+  score_t scores;
+  ids_t temp_filter;
+  while(tcnt < S && filter.size() != 1)
+  {
+    // column of the testcase we are randomly evaluating
+    const gene_t * col = dmat + test_id[tcnt] * N;
+
+    // create vector of current filter solutions
+    scores.resize(filter.size());
+    for(size_t i = 0; i < filter.size(); ++i) {scores[i] = col[filter[i]];}
+
+    // group org ids by performance in descending order
+    fitgp_t group = FitnessGroup(scores);
+
+    // update the filter vector with pop ids that are worthy
+    temp_filter.swap(filter);
+    filter.clear();
+    for(const auto & p : group)
+    {
+      if(Distance(group.begin()->first, p.first) <= epsi)
+      {
+        for(auto id : p.second) {filter.push_back(temp_filter[id]);}
+      }
+      else{break;}
+    }
+
+    ++tcnt;
+  }
+
+  // Get a random position from the remaining filtered solutions (may be one left too)
+  emp_assert(0 < filter.size());
+  return filter[rng.GetUInt(static_cast<uint32_t>(filter.size()))];
+}
+
 size_t Selection::CELexicase(const fmatrix_t & mscore, const double epsi, const ids_t & pop_coh, const ids_t & test_coh)
 {
+  NextStream();
+
   // quick checks
   emp_assert(0 < mscore.size()); emp_assert(0 <= epsi);
   emp_assert(0 < pop_coh.size()); emp_assert(0 < test_coh.size());
@@ -769,7 +1249,7 @@ size_t Selection::CELexicase(const fmatrix_t & mscore, const double epsi, const
   // create a vector of shuffled testcase ids
   ids_t test_id(test_coh.size());
   std::iota(test_id.begin(), test_id.end(), 0);
-  emp::Shuffle(*random, test_id);
+  Shuffle(test_id);
 
   // create vector to hold filtered elite solutions from pop_coh
   ids_t filter(pop_coh.size());
@@ -816,14 +1296,14 @@ size_t Selection::CELexicase(const fmatrix_t & mscore, const double epsi, const
 
   // Get a random position from the remaining filtered solutions (may be one left too)
   emp_assert(0 < filter.size());
-  size_t wid = emp::Choose(*random, filter.size(), 1)[0];
+  size_t wid = Choose(filter.size(), 1)[0];
 
   return pop_coh[filter[wid]];
 }
 
 ///< helper functions
 
-double Selection::Pnorm(const score_t & x, const score_t & y, const double exp)
+double Selection::Pnorm(const row_t & x, const row_t & y, const double exp)
 {
   // quick checks
   emp_assert(0 < x.size()); emp_assert(0 < y.size());
@@ -831,20 +1311,20 @@ double Selection::Pnorm(const score_t & x, const score_t & y, const double exp)
 
   // subtract one vector from the other and take the exp of that
   score_t diff(x.size());
-  for(size_t i = 0; i < x.size(); ++i){diff[i] = std::pow((x[i] - y[i]), exp);}
+  for(size_t i = 0; i < x.size(); ++i){diff[i] = std::pow((static_cast<double>(x[i]) - y[i]), exp);}
 
   double tot = std::accumulate(diff.begin(), diff.end(), 0.0);
 
   return std::pow(tot, (1.0/exp));
 }
 
-Selection::fmatrix_t Selection::SimilarityMatrix(const gmatrix_t & genome, const double exp)
+Selection::dmatrix_t Selection::SimilarityMatrix(const gmatrix_t & genome, const double exp)
 {
   // quick checks
   emp_assert(1 <= exp); emp_assert(1 < genome.size());
 
   // generate the matrix, lower diagnonal matrix filled (not include i == j)
-  fmatrix_t similar(genome.size());
+  dmatrix_t similar(genome.size());
   for(auto & s : similar) {s.resize(genome.size(), ERROR_VALD);}
 
   for(size_t i = 0; i < genome.size(); ++i)
@@ -0,0 +1,387 @@
+/// Binary columnar snapshots of a phylogeny
+///
+/// File layout (little-endian on every host, every column 8-byte aligned):
+///
+///   header (64 bytes)
+///     char[8]   magic        "DIAPHYLO"
+///     uint32    version      layout version (SNAP_VERSION)
+///     uint32    flags        SNAP_ZLIB if the column block is deflated
+///     uint64    update       update the snapshot was taken at
+///     uint64    taxa         number of rows N
+///     uint64    geno_width   doubles per genotype G (gene_t values widened to double)
+///     uint64    phen_width   doubles per phenotype P
+///     uint64    body_size    size of the column block in bytes (uncompressed)
+///     uint64    stored_size  bytes of column block following the header
+///
+///   column block (N rows, taxa sorted by id)
+///     uint64    id[N]
+///     uint64    parent[N]           SNAP_NO_PARENT for roots
+///     double    origin_time[N]
+///     double    destruction_time[N] inf while the taxon is alive
+///     uint64    num_orgs[N]
+///     uint64    tot_orgs[N]
+///     uint64    num_offspring[N]
+///     uint64    total_offspring[N]
+///     uint64    depth[N]
+///     double    fitness[N]
+///     double    genotype[N*G]       row major, NaN padded
+///     double    phenotype[N*P]      row major, NaN padded
+///
+///   delta tail (only when flags has SNAP_DELTA, still inside the column block)
+///     uint64    base_update         update of the snapshot this delta builds on
+///     uint64    removed             number of ids R dropped from the tree since base_update
+///     uint64    removed_id[R]
+///
+/// A delta snapshot only holds rows for taxa that are new or changed since base_update.
+/// The tree at a delta's update is the last full snapshot with every later delta applied in order:
+/// drop the removed ids, then replace/insert the delta rows.
+///
+/// Uncompressed files can be memory mapped directly (see DataTools/Collector/phylo-snapshot.py).
+/// Big-endian hosts swap every value on the way out, so readers can always assume little-endian.
+
+#ifndef DIA_SNAPSHOT_H
+#define DIA_SNAPSHOT_H
+
+///< standard headers
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#ifdef DIA_SNAPSHOT_ZLIB
+#include <zlib.h>
+#endif
+
+///< empirical headers
+#include "emp/base/Ptr.hpp"
+#include "emp/base/vector.hpp"
+
+///< experiment headers
+#include "precision.h"
+
+///< constant vars
+constexpr uint32_t SNAP_VERSION = 1;
+constexpr uint32_t SNAP_ZLIB = 1u << 0;
+constexpr uint32_t SNAP_DELTA = 1u << 1;
+constexpr uint64_t SNAP_NO_PARENT = std::numeric_limits<uint64_t>::max();
+
+// files are little-endian, big-endian hosts swap on write
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool SNAP_SWAP = true;
+#else
+constexpr bool SNAP_SWAP = false;
+#endif
+
+// value in file (little-endian) byte order
+template <typename T>
+T SnapLittle(T v)
+{
+  if(!SNAP_SWAP) {return v;}
+  unsigned char b[sizeof(T)];
+  std::memcpy(b, &v, sizeof(T));
+  std::reverse(b, b + sizeof(T));
+  std::memcpy(&v, b, sizeof(T));
+  return v;
+}
+
+struct SnapshotHeader
+{
+  char magic[8] = {'D','I','A','P','H','Y','L','O'};
+  uint32_t version = SNAP_VERSION;
+  uint32_t flags = 0;
+  uint64_t update = 0;
+  uint64_t taxa = 0;
+  uint64_t geno_width = 0;
+  uint64_t phen_width = 0;
+  uint64_t body_size = 0;
+  uint64_t stored_size = 0;
+};
+
+// header with every field in file byte order
+SnapshotHeader SnapLittle(SnapshotHeader h)
+{
+  h.version = SnapLittle(h.version); h.flags = SnapLittle(h.flags);
+  h.update = SnapLittle(h.update); h.taxa = SnapLittle(h.taxa);
+  h.geno_width = SnapLittle(h.geno_width); h.phen_width = SnapLittle(h.phen_width);
+  h.body_size = SnapLittle(h.body_size); h.stored_size = SnapLittle(h.stored_size);
+  return h;
+}
+
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must stay 64 bytes");
+
+template <typename TAXON>
+class PhyloSnapshot
+{
+  // object types for consistency between working class
+  public:
+    // taxon type being written
+    using taxon_t = TAXON;
+    // taxon pointer
+    using taxon_p = emp::Ptr<taxon_t>;
+    // serialized snapshot bytes
+    using bytes_t = emp::vector<char>;
+    // taxon fitness extractor
+    using fit_fun_t = std::function<double(const taxon_t &)>;
+    // taxon genotype / phenotype extractor
+    using vec_fun_t = std::function<const emp::vector<gene_t> & (const taxon_t &)>;
+
+  public:
+
+    PhyloSnapshot(fit_fun_t _fit, vec_fun_t _geno, vec_fun_t _phen, size_t _g, size_t _p) :
+      get_fit(_fit), get_geno(_geno), get_phen(_phen), geno_width(_g), phen_width(_p) {;}
+
+    /**
+     * Serialize function:
+     *
+     * Packs the given taxa into the columnar layout described at the top of this file.
+     *
+     * @param taxa Every taxon in the tree (active, ancestors, ...).
+     * @param update Update the snapshot is being taken at.
+     * @param compress Deflate the column block (needs DIA_SNAPSHOT_ZLIB).
+     *
+     * @return header and column block, ready to be written.
+     */
+    bytes_t Serialize(emp::vector<taxon_p> taxa, const size_t update, const bool compress) const;
+
+    /**
+     * Serialize Delta function:
+     *
+     * Packs only the taxa that are new or changed since the previous call, plus the ids that left the tree.
+     * A full snapshot is packed instead when requested (or on the first call) and becomes the new base.
+     *
+     * @param taxa Every taxon in the tree (active, ancestors, ...).
+     * @param update Update the snapshot is being taken at.
+     * @param compress Deflate the column block (needs DIA_SNAPSHOT_ZLIB).
+     * @param full Write a full checkpoint instead of a delta.
+     *
+     * @return header and column block, ready to be written.
+     */
+    bytes_t SerializeDelta(emp::vector<taxon_p> taxa, const size_t update, const bool compress, const bool full);
+
+    // write serialized bytes to a file
+    static bool WriteFile(const std::string & path, const bytes_t & bytes);
+
+    // serialize + write in one go
+    bool Write(const std::string & path, const emp::vector<taxon_p> & taxa, const size_t update, const bool compress) const
+    {
+      return WriteFile(path, Serialize(taxa, update, compress));
+    }
+
+  private:
+    // taxon fields that can change after a row was written
+    struct RowState
+    {
+      uint64_t parent;
+      uint64_t num_orgs, tot_orgs, num_off, tot_off;
+      double destruction, fitness;
+
+      bool operator==(const RowState & o) const
+      {
+        return parent == o.parent && num_orgs == o.num_orgs && tot_orgs == o.tot_orgs && num_off == o.num_off
+            && tot_off == o.tot_off && destruction == o.destruction && fitness == o.fitness;
+      }
+    };
+
+    // current state of a taxon
+    RowState State(const taxon_t & tax) const
+    {
+      return {tax.GetParent() ? tax.GetParent()->GetID() : SNAP_NO_PARENT, tax.GetNumOrgs(), tax.GetTotOrgs(),
+              tax.GetNumOff(), tax.GetTotalOffspring(), tax.GetDestructionTime(), get_fit(tax)};
+    }
+
+    // sort taxa by id so rows are stable between snapshots
+    static void SortTaxa(emp::vector<taxon_p> & taxa)
+    {
+      std::sort(taxa.begin(), taxa.end(), [](const taxon_p & a, const taxon_p & b) {
+        return a->GetID() < b->GetID();
+      });
+    }
+
+    // pack sorted taxa into header + columns, with an optional delta tail
+    bytes_t Pack(const emp::vector<taxon_p> & taxa, const size_t update, const bool compress, const uint32_t flags, const emp::vector<uint64_t> & tail) const;
+
+    // append a column of values to the body
+    template <typename T>
+    static void PutColumn(bytes_t & body, const emp::vector<T> & col)
+    {
+      const size_t at = body.size();
+      body.resize(at + col.size() * sizeof(T));
+      if(col.size() == 0) {return;}
+      if(!SNAP_SWAP) {std::memcpy(body.data() + at, col.data(), col.size() * sizeof(T)); return;}
+      for(size_t i = 0; i < col.size(); ++i)
+      {
+        const T v = SnapLittle(col[i]);
+        std::memcpy(body.data() + at + i * sizeof(T), &v, sizeof(T));
+      }
+    }
+
+    // fill a fixed width row from a vector, NaN padded
+    static void PutRow(emp::vector<double> & col, const size_t row, const size_t width, const emp::vector<gene_t> & v)
+    {
+      const size_t cnt = std::min(width, v.size());
+      std::copy(v.begin(), v.begin() + cnt, col.begin() + row * width);
+      std::fill(col.begin() + row * width + cnt, col.begin() + (row + 1) * width, std::numeric_limits<double>::quiet_NaN());
+    }
+
+  private:
+    // column extractors
+    fit_fun_t get_fit;
+    vec_fun_t get_geno;
+    vec_fun_t get_phen;
+
+    // fixed row widths
+    size_t geno_width;
+    size_t phen_width;
+
+    // row states written up to the last snapshot (delta mode)
+    std::unordered_map<uint64_t, RowState> written;
+    // update of the last snapshot (delta mode)
+    size_t base_update = 0;
+    // has a full snapshot been written yet? (delta mode)
+    bool based = false;
+};
+
+template <typename TAXON>
+typename PhyloSnapshot<TAXON>::bytes_t PhyloSnapshot<TAXON>::Serialize(emp::vector<taxon_p> taxa, const size_t update, const bool compress) const
+{
+  SortTaxa(taxa);
+  return Pack(taxa, update, compress, 0, {});
+}
+
+template <typename TAXON>
+typename PhyloSnapshot<TAXON>::bytes_t PhyloSnapshot<TAXON>::SerializeDelta(emp::vector<taxon_p> taxa, const size_t update, const bool compress, const bool full)
+{
+  SortTaxa(taxa);
+
+  // states of the tree as it is now
+  std::unordered_map<uint64_t, RowState> current;
+  current.reserve(taxa.size());
+  for(auto tax : taxa) {current.emplace(tax->GetID(), State(*tax));}
+
+  // full checkpoint becomes the new base
+  if(full || !based)
+  {
+    written.swap(current);
+    base_update = update;
+    based = true;
+    return Pack(taxa, update, compress, 0, {});
+  }
+
+  // rows that are new or changed since the base
+  emp::vector<taxon_p> changed;
+  for(auto tax : taxa)
+  {
+    const auto it = written.find(tax->GetID());
+    if(it == written.end() || !(it->second == current[tax->GetID()])) {changed.push_back(tax);}
+  }
+
+  // ids that left the tree since the base
+  emp::vector<uint64_t> tail{static_cast<uint64_t>(base_update), 0};
+  for(const auto & w : written)
+  {
+    if(current.find(w.first) == current.end()) {tail.push_back(w.first);}
+  }
+  std::sort(tail.begin() + 2, tail.end());
+  tail[1] = tail.size() - 2;
+
+  written.swap(current);
+  base_update = update;
+
+  return Pack(changed, update, compress, SNAP_DELTA, tail);
+}
+
+template <typename TAXON>
+typename PhyloSnapshot<TAXON>::bytes_t PhyloSnapshot<TAXON>::Pack(const emp::vector<taxon_p> & taxa, const size_t update, const bool compress, const uint32_t flags, const emp::vector<uint64_t> & tail) const
+{
+  const size_t N = taxa.size();
+  emp::vector<uint64_t> id(N), parent(N), num_orgs(N), tot_orgs(N), num_off(N), tot_off(N), depth(N);
+  emp::vector<double> origin(N), destruction(N), fitness(N);
+  emp::vector<double> geno(N * geno_width), phen(N * phen_width);
+
+  for(size_t i = 0; i < N; ++i)
+  {
+    const taxon_t & tax = *taxa[i];
+    id[i] = tax.GetID();
+    parent[i] = tax.GetParent() ? tax.GetParent()->GetID() : SNAP_NO_PARENT;
+    origin[i] = tax.GetOriginationTime();
+    destruction[i] = tax.GetDestructionTime();
+    num_orgs[i] = tax.GetNumOrgs();
+    tot_orgs[i] = tax.GetTotOrgs();
+    num_off[i] = tax.GetNumOff();
+    tot_off[i] = tax.GetTotalOffspring();
+    depth[i] = tax.GetDepth();
+    fitness[i] = get_fit(tax);
+    PutRow(geno, i, geno_width, get_geno(tax));
+    PutRow(phen, i, phen_width, get_phen(tax));
+  }
+
+  // lay out columns in documented order
+  bytes_t body;
+  body.reserve(N * (10 + geno_width + phen_width) * sizeof(uint64_t));
+  PutColumn(body, id); PutColumn(body, parent);
+  PutColumn(body, origin); PutColumn(body, destruction);
+  PutColumn(body, num_orgs); PutColumn(body, tot_orgs);
+  PutColumn(body, num_off); PutColumn(body, tot_off);
+  PutColumn(body, depth); PutColumn(body, fitness);
+  PutColumn(body, geno); PutColumn(body, phen);
+  PutColumn(body, tail);
+
+  SnapshotHeader header;
+  header.flags = flags;
+  header.update = update;
+  header.taxa = N;
+  header.geno_width = geno_width;
+  header.phen_width = phen_width;
+  header.body_size = body.size();
+
+  bytes_t out(sizeof(SnapshotHeader));
+
+#ifdef DIA_SNAPSHOT_ZLIB
+  if(compress)
+  {
+    uLongf packed = compressBound(body.size());
+    out.resize(sizeof(SnapshotHeader) + packed);
+    const int res = compress2(reinterpret_cast<Bytef *>(out.data() + sizeof(SnapshotHeader)), &packed,
+                              reinterpret_cast<const Bytef *>(body.data()), body.size(), Z_DEFAULT_COMPRESSION);
+    emp_assert(res == Z_OK);
+    if(res == Z_OK)
+    {
+      out.resize(sizeof(SnapshotHeader) + packed);
+      header.flags |= SNAP_ZLIB;
+      header.stored_size = packed;
+      const SnapshotHeader disk = SnapLittle(header);
+      std::memcpy(out.data(), &disk, sizeof(SnapshotHeader));
+      return out;
+    }
+    out.resize(sizeof(SnapshotHeader));
+  }
+#endif
+
+  header.stored_size = body.size();
+  const SnapshotHeader disk = SnapLittle(header);
+  std::memcpy(out.data(), &disk, sizeof(SnapshotHeader));
+  out.insert(out.end(), body.begin(), body.end());
+
+  return out;
+}
+
+template <typename TAXON>
+bool PhyloSnapshot<TAXON>::WriteFile(const std::string & path, const bytes_t & bytes)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if(!out)
+  {
+    std::cerr << "ERROR: UNABLE TO OPEN SNAPSHOT FILE " << path << std::endl;
+    return false;
+  }
+
+  out.write(bytes.data(), bytes.size());
+  return static_cast<bool>(out);
+}
+
+#endif
@@ -0,0 +1,374 @@
+/// Parameter sweeps: expand a grid / list of treatments into runs and schedule them longest first with work stealing
+
+#ifndef DIA_SWEEP_H
+#define DIA_SWEEP_H
+
+///< standard headers
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+///< empirical headers
+#include "emp/base/vector.hpp"
+
+///< experiment headers
+#include "batch.h"
+#include "config.h"
+#include "world.h"
+
+class SweepScheduler
+{
+  // object types for consistency between working class
+  public:
+    // NAME=VALUE settings
+    using params_t = BatchRunner::params_t;
+
+    // one swept setting and the values it takes
+    using axis_t = std::pair<std::string, emp::vector<std::string>>;
+
+    // one run of the sweep
+    struct Job
+    {
+      // settings handed to the batch runner
+      BatchRunner::Run run;
+      // where the run writes (placeholders filled in)
+      std::string dir;
+      // generations the run goes to
+      size_t gens = 0;
+      // estimated relative run time
+      double cost = 0.0;
+    };
+
+  public:
+
+    // base is the fully parsed configuration (Dia.cfg + command line) every job starts from
+    SweepScheduler(const DiaConfig & base) : runner(base) {}
+
+    /**
+     * Read function:
+     *
+     * Parses a sweep specification and expands it into jobs:
+     *
+     *   SELECTION=4,5,6                        (axis: comma separated values)
+     *   SEED=1-50                              (axis: seed range)
+     *   MAX_GENS=40001                         (single value: fixed setting)
+     *   OUTPUT_DIR=./data/SEL_{SELECTION}__EPS_{LEX_EPS}__SEED_{SEED}/
+     *   SELECTION=4 LEX_EPS=0.0                (several settings: list entry)
+     *   SELECTION=4 LEX_EPS=0.5
+     *
+     * Jobs are every list entry (or the base alone if there are none) crossed with every combination of axis values.
+     * {NAME} in OUTPUT_DIR is replaced by the value of NAME in each job, and every job must end up with its own directory.
+     *
+     * @param path sweep file.
+     *
+     * @return false (and prints why) on unknown settings, malformed lines or clashing output directories.
+     */
+    bool Read(const std::string & path);
+
+    /**
+     * Execute function:
+     *
+     * Skips jobs whose data.csv already reaches MAX_GENS, then runs the rest longest first.
+     * Jobs are dealt round robin onto one deque per worker; a worker that runs dry scans every other deque and steals the longest job left in the sweep.
+     *
+     * @param threads workers (0 = one per hardware thread).
+     *
+     * @return number of jobs that failed.
+     */
+    size_t Execute(size_t threads);
+
+    size_t GetJobCnt() const {return jobs.size();}
+
+    /**
+     * Is Complete function:
+     *
+     * Same test as the DataTools/Checker scripts: data.csv exists and its last row is generation max_gens.
+     *
+     * @param dir output directory of a run.
+     * @param max_gens generations the run was set to reach.
+     *
+     * @return true if the run finished.
+     */
+    static bool IsComplete(const std::string & dir, const size_t max_gens);
+
+    // relative cost of a run (generations * evaluations * per generation selection work)
+    static double Cost(const DiaConfig & config);
+
+  private:
+    // add every job for one list entry
+    bool Expand(const params_t & entry, std::set<std::string> & dirs);
+
+    // replace {NAME} placeholders with the values config holds
+    static std::string Fill(std::string dir, DiaConfig & config);
+
+  private:
+    // runs a single job
+    BatchRunner runner;
+
+    // swept settings
+    emp::vector<axis_t> axes;
+    // settings shared by every job
+    params_t fixed;
+    // list entries (crossed with the axes)
+    emp::vector<params_t> entries;
+
+    // expanded jobs in specification order
+    emp::vector<Job> jobs;
+};
+
+bool SweepScheduler::Read(const std::string & path)
+{
+  std::ifstream in(path);
+  if(!in.is_open()) {std::cerr << "SWEEP FILE DOES NOT EXIST: " << path << std::endl; return false;}
+
+  std::string text;
+  for(size_t line = 1; std::getline(in, text); ++line)
+  {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if(first == std::string::npos || text[first] == '#') {continue;}
+
+    std::istringstream tokens(text);
+    emp::vector<std::string> toks;
+    for(std::string tok; tokens >> tok;) {toks.push_back(tok);}
+
+    // list entry
+    if(1 < toks.size())
+    {
+      params_t entry;
+      for(const auto & tok : toks)
+      {
+        BatchRunner::Setting set;
+        if(!BatchRunner::Parse("SWEEP", line, tok, set)) {return false;}
+        entry.emplace_back(set.name, set.value);
+      }
+      entries.push_back(entry);
+      continue;
+    }
+
+    BatchRunner::Setting set;
+    if(!BatchRunner::Parse("SWEEP", line, toks[0], set)) {return false;}
+    const std::string & name = set.name, & value = set.value;
+
+    // seed range axis
+    if(set.range)
+    {
+      axes.push_back({name, {}});
+      for(size_t s = set.seed_lo; s <= set.seed_hi; ++s) {axes.back().second.push_back(std::to_string(s));}
+      continue;
+    }
+
+    // value list axis
+    if(value.find(',') != std::string::npos)
+    {
+      axes.push_back({name, {}});
+      std::istringstream vals(value);
+      for(std::string v; std::getline(vals, v, ',');) {if(v.size()) {axes.back().second.push_back(v);}}
+      if(axes.back().second.size() == 0) {std::cerr << "SWEEP LINE " << line << ": NO VALUES FOR " << name << std::endl; return false;}
+      continue;
+    }
+
+    fixed.emplace_back(name, value);
+  }
+
+  // every job needs a directory of its own
+  std::set<std::string> dirs;
+  if(entries.size() == 0) {entries.emplace_back();}
+  for(const auto & entry : entries) {if(!Expand(entry, dirs)) {return false;}}
+
+  std::cerr << "Sweep file " << path << " expands to " << jobs.size() << " jobs" << std::endl;
+  return true;
+}
+
+bool SweepScheduler::Expand(const params_t & entry, std::set<std::string> & dirs)
+{
+  // odometer over the axis values
+  emp::vector<size_t> at(axes.size(), 0);
+  while(true)
+  {
+    Job job;
+    job.run.line = jobs.size();
+    job.run.params = fixed;
+    for(size_t a = 0; a < axes.size(); ++a) {job.run.params.emplace_back(axes[a].first, axes[a].second[at[a]]);}
+    // list entries win over the grid
+    for(const auto & p : entry) {job.run.params.push_back(p);}
+
+    DiaConfig config;
+    runner.Configure(job.run, config);
+    job.dir = Fill(config.OUTPUT_DIR(), config);
+    job.run.params.emplace_back("OUTPUT_DIR", job.dir);
+    job.gens = config.MAX_GENS();
+    job.cost = Cost(config);
+
+    if(!dirs.insert(job.dir).second)
+    {
+      std::cerr << "SWEEP: TWO JOBS WRITE TO " << job.dir << " (add {NAME} placeholders to OUTPUT_DIR)" << std::endl;
+      return false;
+    }
+    jobs.push_back(std::move(job));
+
+    // next combination
+    size_t a = 0;
+    for(; a < axes.size(); ++a)
+    {
+      if(++at[a] < axes[a].second.size()) {break;}
+      at[a] = 0;
+    }
+    if(a == axes.size()) {return true;}
+  }
+}
+
+std::string SweepScheduler::Fill(std::string dir, DiaConfig & config)
+{
+  for(size_t open = dir.find('{'); open != std::string::npos; open = dir.find('{', open))
+  {
+    const size_t close = dir.find('}', open);
+    if(close == std::string::npos) {break;}
+
+    const std::string name = dir.substr(open + 1, close - open - 1);
+    if(!config.Has(name)) {open = close; continue;}
+
+    const std::string value = config.Get(name);
+    dir.replace(open, close - open + 1, value);
+    open += value.size();
+  }
+
+  return dir;
+}
+
+bool SweepScheduler::IsComplete(const std::string & dir, const size_t max_gens)
+{
+  std::ifstream in(dir + "data.csv");
+  if(!in.is_open()) {return false;}
+
+  // column holding the generation
+  std::string header;
+  if(!std::getline(in, header)) {return false;}
+  std::istringstream cols(header);
+  size_t gen_col = 0;
+  bool found = false;
+  for(std::string col; std::getline(cols, col, ','); ++gen_col)
+  {
+    if(col == "gen") {found = true; break;}
+  }
+  if(!found) {return false;}
+
+  // last non empty row
+  std::string row, last;
+  while(std::getline(in, row)) {if(row.size()) {last = row;}}
+  if(last.empty()) {return false;}
+
+  std::istringstream cells(last);
+  std::string cell;
+  for(size_t c = 0; c <= gen_col; ++c) {if(!std::getline(cells, cell, ',')) {return false;}}
+
+  return std::strtoull(cell.c_str(), nullptr, 10) == max_gens;
+}
+
+double SweepScheduler::Cost(const DiaConfig & config)
+{
+  const double gens = static_cast<double>(config.MAX_GENS());
+  const double pop = static_cast<double>(config.POP_SIZE());
+  const double objs = static_cast<double>(config.OBJECTIVE_CNT());
+
+  // evaluation and mutation are linear in the population
+  double work = pop * objs;
+
+  // same engine the world will run (SELECTION_ENGINE wins over the SELECTION number)
+  const std::string name = DiagWorld::SelectionName(config);
+
+  // fitness sharing, novelty, novelty lexicase: pairwise distances
+  if(name == "fitness_sharing" || name == "novelty" || name == "novelty_lexicase") {work += pop * pop * objs;}
+  // ecoea: resource fitness per org and objective
+  if(name == "ecoea") {work += pop * objs;}
+
+  // tournament based schemes: one tournament of TOUR_SIZE per parent
+  if(name == "tournament" || name == "fitness_sharing" || name == "novelty" || name == "ecoea") {work += pop * config.TOUR_SIZE();}
+
+  // lexicase: each selection filters the candidates it sees
+  if(name == "lexicase") {work += pop * pop;}
+  if(name == "ds_lexicase") {work += pop * pop * config.DSLEX_PROP();}
+  if(name == "cohort_lexicase") {work += pop * pop * config.COH_LEX_PROP();}
+
+  return gens * work;
+}
+
+size_t SweepScheduler::Execute(size_t threads)
+{
+  // resume: skip finished jobs
+  emp::vector<size_t> todo;
+  for(size_t j = 0; j < jobs.size(); ++j) {if(!IsComplete(jobs[j].dir, jobs[j].gens)) {todo.push_back(j);}}
+  std::cerr << "Sweep: " << jobs.size() - todo.size() << " of " << jobs.size() << " jobs already complete" << std::endl;
+  if(todo.size() == 0) {return 0;}
+
+  // longest first
+  std::stable_sort(todo.begin(), todo.end(), [this](size_t a, size_t b) {return jobs[b].cost < jobs[a].cost;});
+
+  if(threads == 0) {threads = std::max<size_t>(1, std::thread::hardware_concurrency());}
+  threads = std::min(threads, todo.size());
+
+  // deal round robin so every deque starts with a similar share of long jobs
+  emp::vector<std::deque<size_t>> queues(threads);
+  emp::vector<std::mutex> locks(threads);
+  for(size_t k = 0; k < todo.size(); ++k) {queues[k % threads].push_back(todo[k]);}
+
+  // front of deque q (longest job left there), false if it is empty
+  auto take = [&queues, &locks](const size_t q, size_t & job)
+  {
+    std::lock_guard<std::mutex> guard(locks[q]);
+    if(queues[q].empty()) {return false;}
+    job = queues[q].front();
+    queues[q].pop_front();
+    return true;
+  };
+
+  // deque (other than w) whose front is the longest job left anywhere, threads if every deque is empty
+  auto longest = [&, this](const size_t w)
+  {
+    size_t best = threads;
+    double best_cost = -1.0;
+    for(size_t q = 0; q < threads; ++q)
+    {
+      if(q == w) {continue;}
+      std::lock_guard<std::mutex> guard(locks[q]);
+      if(queues[q].empty() || jobs[queues[q].front()].cost <= best_cost) {continue;}
+      best = q;
+      best_cost = jobs[queues[q].front()].cost;
+    }
+    return best;
+  };
+
+  std::atomic<size_t> finished{0}, failed{0};
+  auto work = [&, this](const size_t w)
+  {
+    size_t job = 0;
+    while(true)
+    {
+      bool got = take(w, job);
+      // steal the longest job left (rescan if its owner took it first)
+      for(size_t q = w; !got && (q = longest(w)) < threads;) {got = take(q, job);}
+      if(!got) {return;}
+
+      if(!runner.RunOne(jobs[job].run)) {++failed;}
+      runner.Log("Sweep progress: " + std::to_string(++finished) + " / " + std::to_string(todo.size()));
+    }
+  };
+
+  emp::vector<std::thread> workers;
+  for(size_t w = 1; w < threads; ++w) {workers.emplace_back(work, w);}
+  work(0);
+  for(auto & t : workers) {t.join();}
+
+  std::cerr << "Sweep finished: " << todo.size() - failed << " of " << todo.size() << " remaining jobs completed" << std::endl;
+  return failed;
+}
+
+#endif
@@ -0,0 +1,220 @@
+/// Low overhead timers for the phases of a generation
+///
+/// Each phase accumulates steady clock nanoseconds, calls and (optionally) cycle counter ticks.
+/// Sums since the last row go to timing.csv, sums over the whole run go to the end of run summary.
+/// Building with -DDIA_NO_TIMING (make NO_TIMING=1) compiles every timer down to nothing.
+
+#ifndef DIA_TIMING_H
+#define DIA_TIMING_H
+
+///< standard headers
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+#if !defined(DIA_NO_TIMING) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define DIA_TIMING_CYCLES
+#endif
+
+///< empirical headers
+#include "emp/base/assert.hpp"
+
+///< constant vars
+
+// timed phases: the steps of a generation, then work done inside them
+enum class Phase : size_t
+{
+  CHECKPOINT, RESET, EVALUATION, SELECTION, RECORD, REPRODUCTION,
+  POP_FIT_MAT, SIMILARITY, NEAREST, SNAPSHOT, FILE_WRITE,
+  COUNT
+};
+
+constexpr size_t PHASE_CNT = static_cast<size_t>(Phase::COUNT);
+// first sub-phase (earlier phases add up to a generation)
+constexpr size_t PHASE_SUB = static_cast<size_t>(Phase::POP_FIT_MAT);
+
+constexpr std::array<const char *, PHASE_CNT> PHASE_NAMES =
+{
+  "checkpoint", "reset", "evaluation", "selection", "record", "reproduction",
+  "pop_fit_mat", "similarity", "nearest", "snapshot", "file_write"
+};
+
+class PhaseTimer
+{
+  public:
+    using clock_t = std::chrono::steady_clock;
+
+    // totals for one phase
+    struct Slot
+    {
+      uint64_t ns = 0;
+      uint64_t cycles = 0;
+      uint64_t calls = 0;
+    };
+
+    using slots_t = std::array<Slot, PHASE_CNT>;
+
+  public:
+
+    /**
+     * Set Mode function:
+     *
+     * @param mode 0 off, 1 steady clock, 2 steady clock + cycle counter (where the cpu has one).
+     */
+    void SetMode(const size_t mode)
+    {
+#ifdef DIA_NO_TIMING
+      if(mode) {std::cerr << "WARNING: TIMING COMPILED OUT (DIA_NO_TIMING), NO PHASE TIMES RECORDED" << std::endl;}
+#else
+      on = mode > 0;
+      cycles = mode > 1;
+#ifndef DIA_TIMING_CYCLES
+      if(cycles) {std::cerr << "WARNING: NO CYCLE COUNTER ON THIS BUILD, TIMING STEADY CLOCK ONLY" << std::endl;}
+      cycles = false;
+#endif
+#endif
+    }
+
+    bool IsOn() const {return on;}
+    bool HasCycles() const {return cycles;}
+
+    // start timing a phase (phases nest, but a phase never nests in itself)
+    void Start(const Phase p)
+    {
+      const size_t i = static_cast<size_t>(p);
+      emp_assert(i < PHASE_CNT);
+      begin[i] = clock_t::now();
+#ifdef DIA_TIMING_CYCLES
+      if(cycles) {begin_cyc[i] = __rdtsc();}
+#endif
+    }
+
+    // stop timing a phase and add the elapsed time to it
+    void Stop(const Phase p)
+    {
+      const size_t i = static_cast<size_t>(p);
+      emp_assert(i < PHASE_CNT);
+      Slot & s = interval[i];
+#ifdef DIA_TIMING_CYCLES
+      if(cycles) {s.cycles += __rdtsc() - begin_cyc[i];}
+#endif
+      s.ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - begin[i]).count());
+      ++s.calls;
+    }
+
+    // timing.csv header
+    void WriteHeader(std::ostream & out) const {out << "update,phase,calls,seconds,cycles\n";}
+
+    /**
+     * Write Rows function:
+     *
+     * One row per phase that ran since the last call, then the interval is folded into the run totals.
+     *
+     * @param out timing.csv stream.
+     * @param update update the rows are reported at.
+     */
+    void WriteRows(std::ostream & out, const size_t update);
+
+    /**
+     * Summary function:
+     *
+     * Whole run totals per phase, with each generation step's share of the generation.
+     *
+     * @param out stream to print to.
+     */
+    void Summary(std::ostream & out) const;
+
+    // run totals so far (rows not yet written included)
+    Slot GetTotal(const Phase p) const
+    {
+      const size_t i = static_cast<size_t>(p);
+      Slot s = total[i];
+      s.ns += interval[i].ns; s.cycles += interval[i].cycles; s.calls += interval[i].calls;
+      return s;
+    }
+
+  private:
+    // timing at all? cycle counter too?
+    bool on = false;
+    bool cycles = false;
+
+    // start of the running phases
+    std::array<clock_t::time_point, PHASE_CNT> begin;
+    std::array<uint64_t, PHASE_CNT> begin_cyc = {};
+
+    // since the last row
+    slots_t interval = {};
+    // written rows
+    slots_t total = {};
+};
+
+void PhaseTimer::WriteRows(std::ostream & out, const size_t update)
+{
+  for(size_t i = 0; i < PHASE_CNT; ++i)
+  {
+    Slot & s = interval[i];
+    if(s.calls == 0) {continue;}
+
+    out << update << ',' << PHASE_NAMES[i] << ',' << s.calls << ',' << std::setprecision(9) << s.ns * 1e-9 << ',' << s.cycles << '\n';
+
+    total[i].ns += s.ns; total[i].cycles += s.cycles; total[i].calls += s.calls;
+    s = Slot();
+  }
+}
+
+void PhaseTimer::Summary(std::ostream & out) const
+{
+  // generation time is the sum of its steps, sub-phases are shares of the steps they run in
+  uint64_t gen_ns = 0;
+  for(size_t i = 0; i < PHASE_SUB; ++i) {gen_ns += GetTotal(static_cast<Phase>(i)).ns;}
+  if(gen_ns == 0) {return;}
+
+  out << "Phase timing (seconds, calls, ms/call, % of generation" << (cycles ? ", cycles/call" : "") << "):" << std::endl;
+  for(size_t i = 0; i < PHASE_CNT; ++i)
+  {
+    const Slot s = GetTotal(static_cast<Phase>(i));
+    if(s.calls == 0) {continue;}
+
+    out << "  " << std::left << std::setw(14) << PHASE_NAMES[i] << std::right << std::fixed
+        << std::setw(12) << std::setprecision(4) << s.ns * 1e-9
+        << std::setw(10) << s.calls
+        << std::setw(12) << std::setprecision(4) << s.ns * 1e-6 / s.calls
+        << std::setw(8) << std::setprecision(1) << 100.0 * s.ns / gen_ns;
+    if(cycles) {out << std::setw(16) << s.cycles / s.calls;}
+    out << std::defaultfloat << std::endl;
+  }
+}
+
+// times the enclosing scope as one phase (does nothing while the timer is off)
+class ScopedPhase
+{
+  public:
+    ScopedPhase(PhaseTimer & _timer, const Phase _phase) : timer(_timer), phase(_phase), on(_timer.IsOn())
+    {
+      if(on) {timer.Start(phase);}
+    }
+
+    ~ScopedPhase() {if(on) {timer.Stop(phase);}}
+
+    ScopedPhase(const ScopedPhase &) = delete;
+    ScopedPhase & operator=(const ScopedPhase &) = delete;
+
+  private:
+    PhaseTimer & timer;
+    const Phase phase;
+    const bool on;
+};
+
+// DIA_PHASE(timer, Phase::X) times the rest of the enclosing scope
+#ifdef DIA_NO_TIMING
+#define DIA_PHASE(timer, phase)
+#else
+#define DIA_PHASE_CAT2(a, b) a##b
+#define DIA_PHASE_CAT(a, b) DIA_PHASE_CAT2(a, b)
+#define DIA_PHASE(timer, phase) ScopedPhase DIA_PHASE_CAT(dia_phase_, __LINE__)(timer, phase)
+#endif
+
+#endif
@@ -4,21 +4,66 @@
 #define DIA_WORLD_H
 
 ///< standard headers
+#include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <map>
 #include <set>
+#include <string>
 
 ///< empirical headers
 #include "emp/Evolve/World.hpp"
-#include "emp/Evolve/Resource.hpp"
 #include "emp/math/Random.hpp"
 #include "emp/math/random_utils.hpp"
 
 ///< experiment headers
+#include "checkpoint.h"
 #include "config.h"
+#include "ecoea.h"
+#include "engine.h"
+#include "mutation.h"
 #include "org.h"
+#include "output.h"
+#include "parallel.h"
+#include "phylogeny.h"
 #include "problem.h"
+#include "rng.h"
 #include "selection.h"
+#include "snapshot.h"
+#include "timing.h"
+
+///< constant vars
+
+// engine names behind the SELECTION & DIAGNOSTIC numbers
+const emp::vector<std::string> SELECTION_NAMES = {"mu_lambda", "tournament", "fitness_sharing", "novelty", "lexicase",
+                                                  "ds_lexicase", "cohort_lexicase", "novelty_lexicase", "ecoea"};
+const emp::vector<std::string> DIAGNOSTIC_NAMES = {"exploitation", "struct_exploitation", "strong_ecology", "exploration", "weak_ecology"};
+
+// statistics consumers (data file, progress print) declare they read, or-ed together
+enum TrackedStat : size_t
+{
+  STAT_NONE = 0,
+  // population data nodes
+  STAT_POP_NODES = 1,
+  // parent data nodes
+  STAT_PNT_NODES = 2,
+  // elite position
+  STAT_ELITE = 4,
+  // optimal position
+  STAT_OPTIMAL = 8,
+  // common solution dictionary & position
+  STAT_COMMON = 16,
+  // unique optimized objectives
+  STAT_UNI_OBJ = 32,
+  // unique starting positions
+  STAT_UNI_START = 64
+};
+
+constexpr size_t STAT_CNT = 7;
+
+// statistics each one reuses (by bit position): elite & optimal come out of the population node pass,
+// unique objectives is known at once when the optimal solution has every objective
+constexpr size_t STAT_DEPS[STAT_CNT] = {STAT_NONE, STAT_NONE, STAT_POP_NODES, STAT_POP_NODES, STAT_NONE, STAT_OPTIMAL, STAT_NONE};
 
 
 template <typename PHEN_TYPE>
@@ -35,22 +80,40 @@ struct pheno_info
 
   emp::DataNode<double, emp::data::Current, emp::data::Range> fitness; /// This taxon's fitness (for assessing deleterious mutational steps)
   PHEN_TYPE phenotype; /// This taxon's phenotype (for assessing phenotypic change)
+  double fit_total = 0.0; /// Sum and count of recorded fitnesses (mean is restorable from a checkpoint)
+  size_t fit_cnt = 0;
 
   const PHEN_TYPE & GetPhenotype() const {
     return phenotype;
   }
 
+  // same arithmetic as fitness.GetMean()
   const double GetFitness() const {
-    return fitness.GetMean();
+    return fit_total / static_cast<double>(fit_cnt);
   }
 
   void RecordFitness(double fit) {
     fitness.Add(fit);
+    fit_total += fit;
+    ++fit_cnt;
   }
 
   void RecordPhenotype(PHEN_TYPE phen) {
     phenotype = phen;
   }
+
+  void Save(CheckpointWriter & out) const {
+    out.Put<double>(fit_total);
+    out.Put<uint64_t>(fit_cnt);
+    out.PutVec(phenotype);
+  }
+
+  void Load(CheckpointReader & in) {
+    fit_total = in.Get<double>();
+    fit_cnt = in.Get<uint64_t>();
+    phenotype = in.GetVec<typename PHEN_TYPE::value_type>();
+    if(fit_cnt) {fitness.Add(GetFitness());}
+  }
 };
 
 class DiagWorld : public emp::World<Org>
@@ -59,10 +122,12 @@ class DiagWorld : public emp::World<Org>
   public:
     ///< Org related
 
-    // solution genome + diagnotic problem types
-    using genome_t = emp::vector<double>;
+    // solution genome + diagnotic problem types (gene_t, see precision.h)
+    using genome_t = Org::genome_t;
     // score vector for a solution
-    using score_t = emp::vector<double>;
+    using score_t = Org::score_t;
+    // one fitness value per solution (aggregates, transformed fitness)
+    using fit_t = emp::vector<double>;
     // boolean optimal vector per objective
     using optimal_t = emp::vector<bool>;
     // target vector type
@@ -76,10 +141,12 @@ class DiagWorld : public emp::World<Org>
     using fmatrix_t = emp::vector<score_t>;
     // matrix of population genomes
     using gmatrix_t = emp::vector<genome_t>;
+    // matrix of pairwise genome distances
+    using dmatrix_t = emp::vector<fit_t>;
     // map holding population id groupings by fitness (keys in decending order)
     using fitgp_t = std::map<double, ids_t, std::greater<double>>;
     // vector of double vectors for K neighborhoods
-    using neigh_t = emp::vector<score_t>;
+    using neigh_t = emp::vector<fit_t>;
     // vector of vector position ids that represent cohort assignment
     using cohort_t = emp::vector<ids_t>;
 
@@ -87,8 +154,27 @@ class DiagWorld : public emp::World<Org>
 
     // evaluation function type
     using eval_t = std::function<double(Org &)>;
+
+    // inputs built once per generation for the selection engine (only those it asked for are set)
+    struct SelectionInputs
+    {
+      // aggregate score per org (DATA_AGGREGATE)
+      const fit_t * aggregate = nullptr;
+      // score vector per org (DATA_SCORES)
+      const fmatrix_t * scores = nullptr;
+      // genome per org (DATA_GENOMES)
+      const gmatrix_t * genomes = nullptr;
+      // score vector + novelty column per org (DATA_NOVELTY)
+      const fmatrix_t * novelty = nullptr;
+    };
+
     // selection function type
-    using sele_t = std::function<ids_t()>;
+    using sele_t = std::function<ids_t(const SelectionInputs &)>;
+
+    // selection engine: installs its select function (SetSelectFun) and returns the inputs it needs (EngineData)
+    using sele_engine_t = std::function<size_t(DiagWorld &)>;
+    // diagnostic engine: installs its evaluation function (SetEvaluateFun)
+    using diag_engine_t = std::function<void(DiagWorld &)>;
 
     ///< data tracking stuff (ask about)
     using nodef_t = emp::Ptr<emp::DataMonitor<double>>;
@@ -96,12 +182,15 @@ class DiagWorld : public emp::World<Org>
     using como_t = std::map<size_t, ids_t>;
 
     ///< systematics tracking types
-    using gen_systematics_t = emp::Systematics<Org, Org::genome_t, pheno_info<typename Org::score_t>>;
+    using gen_systematics_t = CompactSystematics<Org, Org::genome_t, pheno_info<typename Org::score_t>>;
     using gen_taxon_t = typename gen_systematics_t::taxon_t;
 
-    using phen_systematics_t = emp::Systematics<Org, Org::score_t, pheno_info<typename Org::score_t>>;
+    using phen_systematics_t = CompactSystematics<Org, Org::score_t, pheno_info<typename Org::score_t>>;
     using phen_taxon_t = typename phen_systematics_t::taxon_t;
 
+    // binary phylogeny snapshot writer
+    using gen_snapshot_t = PhyloSnapshot<gen_taxon_t>;
+
     using config_t = DiaConfig;
 
 
@@ -109,11 +198,17 @@ class DiagWorld : public emp::World<Org>
 
     DiagWorld(DiaConfig & _config) :
       config(_config),
-      data_file(_config.OUTPUT_DIR() + "data.csv"),
-      phylodiversity_file(_config.OUTPUT_DIR() + "phylodiversity.csv")
+      data_out(_config.OUTPUT_DIR() + "data.csv"),
+      phylodiversity_out(_config.OUTPUT_DIR() + "phylodiversity.csv"),
+      data_file(data_out.GetStream()),
+      phylodiversity_file(phylodiversity_out.GetStream())
     {
       // set random pointer seed
       random_ptr = emp::NewPtr<emp::Random>(config.SEED());
+      run_seed = static_cast<uint64_t>(static_cast<int64_t>(random_ptr->GetSeed()));
+
+      // pick up where an earlier (killed) run of this treatment left off
+      if(config.CHECKPOINT_RESUME()) {ReadCheckpoint();}
 
       // initialize the world
       Initialize();
@@ -123,10 +218,28 @@ class DiagWorld : public emp::World<Org>
     {
       selection.Delete();
       diagnostic.Delete();
+      if(mutator) {mutator.Delete();}
+      if(pool) {pool.Delete();}
+      if(ecoea) {ecoea.Delete();}
+      if(config.ORG_ALLOC()) {std::cerr << "Organism arena heap allocations: " << OrgArena::Local().GetHeapCnt() << std::endl;}
       pop_fit.Delete();
       pop_opti.Delete();
       pnt_fit.Delete();
       pnt_opti.Delete();
+      if(gen_snapshot) {gen_snapshot.Delete();}
+      if(resume_from) {resume_from.Delete();}
+
+      // phases since the last timing row, then the whole run
+      if(timer.IsOn()) {timer.WriteRows(timing_file, GetUpdate()); timing_file.close(); timer.Summary(std::cerr);}
+
+      // everything still buffered reaches disk before we go
+      data_out.Drain();
+      phylodiversity_out.Drain();
+      if(writer) {writer->Close(); writer.Delete();}
+
+      // rows a resumed run wrote on the side go back into the systematics files
+      if(resume_at) {FinishCsv(SysFilePath("genotype")); FinishCsv(SysFilePath("phenotype"));}
+      if(resume_at && timer.IsOn()) {FinishCsv(TimingPath());}
     }
 
     ///< functions called to setup the world
@@ -137,6 +250,9 @@ class DiagWorld : public emp::World<Org>
     // set OnUpdate function from World.h
     void SetOnUpdate();
 
+    // set where data files and snapshots are written from
+    void SetOutput();
+
     // set mutation operator from World.h
     void SetMutation();
 
@@ -152,10 +268,64 @@ class DiagWorld : public emp::World<Org>
     // set data tracking with data nodes
     void SetDataTracking();
 
+    // set where organisms are allocated from
+    void SetAllocation();
+
     // populate the world with initial solutions
     void PopulateWorld();
 
 
+    ///< checkpoint & restart
+
+    // load OUTPUT_DIR/checkpoint.bin and check it belongs to this configuration (resume_from stays null if not)
+    void ReadCheckpoint();
+
+    // place the checkpointed population (before systematics are tracking)
+    void RestorePopulation();
+
+    // rebuild the systematics trees and data file positions of the checkpoint
+    void RestoreTracking();
+
+    // reseed at a checkpoint boundary and save the state this update starts from
+    void CheckpointStep(const size_t gen);
+
+    // write OUTPUT_DIR/checkpoint.bin
+    void WriteCheckpoint();
+
+    // systematics file of a manager (resumed runs write new rows beside it)
+    std::string SysFilePath(const std::string & name) const {return config.OUTPUT_DIR() + name + "_systematics.csv";}
+
+    // phase timing file (TIMING, resumed runs write new rows beside it like the systematics files)
+    std::string TimingPath() const {return config.OUTPUT_DIR() + "timing.csv";}
+
+
+    ///< engine registries
+
+    // selection engines by name (built in schemes are registered on first use)
+    static EngineRegistry<sele_engine_t> & SelectionEngines();
+
+    // engine a configuration selects with: SELECTION_ENGINE, or the one behind the SELECTION number ("" if neither)
+    static std::string SelectionName(const DiaConfig & config)
+    {
+      if(!config.SELECTION_ENGINE().empty()) {return config.SELECTION_ENGINE();}
+      return config.SELECTION() < SELECTION_NAMES.size() ? SELECTION_NAMES[config.SELECTION()] : "";
+    }
+
+    // diagnostic engines by name (built in diagnostics are registered on first use)
+    static EngineRegistry<diag_engine_t> & DiagnosticEngines();
+
+    // what engines install
+    void SetSelectFun(const sele_t & s) {select = s;}
+    void SetEvaluateFun(const eval_t & e) {evaluate = e;}
+    // where the gen=... progress lines go (std::cout unless a batch gives the run its own log)
+    void SetProgress(std::ostream & out) {progress = &out;}
+
+    // what engines build on
+    Selection & GetSelector() {emp_assert(selection); return *selection;}
+    Diagnostic & GetDiagnostic() {emp_assert(diagnostic); return *diagnostic;}
+    const config_t & GetConfig() const {return config;}
+
+
     ///< principle steps during an evolutionary run
 
     // reset all data step
@@ -170,6 +340,9 @@ class DiagWorld : public emp::World<Org>
     // reprodutive step
     void ReproductionStep();
 
+    // reproductive step with one population-wide mutation pass (MUTATE_BATCH)
+    void BatchReproductionStep();
+
     // record data step
     void RecordData();
 
@@ -196,6 +369,10 @@ class DiagWorld : public emp::World<Org>
 
     ///< evaluation function implementations
 
+    // compile time kernels for OBJECTIVE_CNT == M (false if diag is not one of DIAGNOSTIC_NAMES)
+    template <size_t M>
+    bool SetFixedEvaluation(const size_t diag);
+
     void Exploitation();
 
     void StructuredExploitation();
@@ -211,18 +388,47 @@ class DiagWorld : public emp::World<Org>
 
     size_t UniqueObjective();
 
-    size_t FindElite();
-
     size_t FindCommon();
 
-    size_t FindOptimized();
-
     size_t FindUniqueStart();
 
+    // fill the population data nodes, finding the elite & optimal positions on the way
+    void FillPopNodes();
+
+    // fill the parent data nodes
+    void FillPntNodes();
+
+    ///< statistics computed only in generations a consumer declared it reads them
+
+    // need plus every statistic it reuses
+    static size_t StatClosure(size_t need);
+
+    /**
+     * Track Stats function:
+     *
+     * Computes the statistics in need (TrackedStat flags), and the ones they reuse,
+     * that have not been computed yet this generation. Each is computed at most once per generation.
+     *
+     * @param need statistics a consumer is about to read.
+     */
+    void TrackStats(const size_t need);
+
+    // elite position (computed if no consumer declared it)
+    size_t GetElitePos() {TrackStats(STAT_ELITE); return elite_pos;}
+
+    // common position & dictionary (computed if no consumer declared it)
+    size_t GetCommonPos() {TrackStats(STAT_COMMON); return comm_pos;}
+
+    // optimal position (computed if no consumer declared it)
+    size_t GetOptimalPos() {TrackStats(STAT_OPTIMAL); return opti_pos;}
+
     void SnapshotPhylogony();
 
     void SnapshotConfig(const config_t & config);
 
+    // write a serialized binary snapshot (through the background writer when ASYNC_OUTPUT)
+    void WriteSnapshot(const std::string & path, const gen_snapshot_t::bytes_t & bytes);
+
     ///< helper functions
 
     // create a matrix of popultion score vectors
@@ -231,6 +437,15 @@ class DiagWorld : public emp::World<Org>
     // create matrix of population genomes
     gmatrix_t PopGenomes();
 
+    // create a column-major matrix of population scores on the sampled testcases only
+    score_t PopSampleMat(const ids_t & t_cases);
+
+    // create one row per org of its scores on the sampled testcases only (LexReduce input)
+    fmatrix_t PopSampleRows(const ids_t & t_cases);
+
+    // cohort lexicase parents, each cohort on its own dense submatrix & random stream (across the pool)
+    ids_t ParallelCohorts(const cohort_t & pop_cohorts, const cohort_t & test_cohorts);
+
 
   private:
     // experiment configurations
@@ -240,8 +455,8 @@ class DiagWorld : public emp::World<Org>
 
     // target vector
     target_t target;
-    // vector holding population aggregate scores (by position id)
-    score_t fit_vec;
+    // vector holding population aggregate scores (by position id), only built for engines asking for DATA_AGGREGATE
+    fit_t fit_vec;
     // vector holding parent solutions selected by selection scheme
     ids_t parent_vec;
 
@@ -250,15 +465,46 @@ class DiagWorld : public emp::World<Org>
     eval_t evaluate;
     // selection lambda we set
     sele_t select;
+    // inputs the selection engine asked for (EngineData)
+    size_t select_data = DATA_NONE;
+    // per generation selection inputs (built only if asked for)
+    fmatrix_t sel_scores;
+    fmatrix_t sel_novelty;
+    gmatrix_t sel_genomes;
 
 
     // select.h var
     emp::Ptr<Selection> selection;
     // problem.h var
     emp::Ptr<Diagnostic> diagnostic;
+    // mutation.h var (MUTATE_SKIP)
+    emp::Ptr<MutationKernel> mutator = nullptr;
+    // precision.h var (GENE_ROUNDING)
+    GeneCodec codec;
+    // parallel.h var (THREAD_CNT)
+    emp::Ptr<ThreadPool> pool = nullptr;
+
+    ///< batched reproduction (MUTATE_BATCH)
+
+    // next generation genomes, one row of OBJECTIVE_CNT genes per offspring
+    emp::vector<gene_t> batch_genomes;
+    // one random stream and kernel per chunk of offspring rows
+    emp::vector<emp::Random> batch_random;
+    emp::vector<MutationKernel> batch_kernels;
 
     ///< data file & node related variables
 
+    // streams the data files write into (drained every data update)
+    OutputStream data_out;
+    OutputStream phylodiversity_out;
+    // background writer (ASYNC_OUTPUT)
+    emp::Ptr<AsyncWriter> writer = nullptr;
+    // per phase run times (TIMING) and the file they go to
+    PhaseTimer timer;
+    std::ofstream timing_file;
+    // progress lines (PRINT_INTERVAL)
+    std::ostream * progress = &std::cout;
+
     // file we are working with
     emp::DataFile data_file;
     emp::DataFile phylodiversity_file;
@@ -266,6 +512,10 @@ class DiagWorld : public emp::World<Org>
     // systematics tracking
     emp::Ptr<gen_systematics_t> gen_sys_ptr;
     emp::Ptr<phen_systematics_t> phen_sys_ptr;
+    // binary snapshot writer (SNAP_FORMAT == 1)
+    emp::Ptr<gen_snapshot_t> gen_snapshot = nullptr;
+    // binary snapshots written so far
+    size_t snap_cnt = 0;
     // node to track population fitnesses
     nodef_t pop_fit;
     // node to track population opitmized count
@@ -285,9 +535,33 @@ class DiagWorld : public emp::World<Org>
     size_t opti_pos;
     // common solution dictionary
     como_t common;
-
-    emp::vector<emp::Resource> ecoea_resources;
-    emp::vector<std::function<double(Org&)>> ecoea_fitset;
+    // unique optimized objectives & starting positions
+    size_t uni_obj = 0;
+    size_t uni_start = 0;
+    // statistics computed this generation (TrackedStat flags)
+    size_t stat_done = STAT_NONE;
+    // statistics the data file declared it reads
+    size_t data_stats = STAT_NONE;
+    // statistics the progress print reads
+    static constexpr size_t PRINT_STATS = STAT_ELITE | STAT_OPTIMAL;
+    // offspring born so far this generation (names counter based mutation streams)
+    size_t birth_cnt = 0;
+
+    ///< checkpoint & restart
+
+    // seed the run was started with (keys counter based streams, survives checkpoint reseeds)
+    uint64_t run_seed = 0;
+    // checkpoint being resumed from, released once restored
+    emp::Ptr<CheckpointReader> resume_from = nullptr;
+    // header of that checkpoint
+    CheckpointHeader resume_hdr;
+    // update this run resumed at (0 = fresh run)
+    size_t resume_at = 0;
+    // next delta snapshot must be a full one (delta base was not checkpointed)
+    bool snap_full = false;
+
+    // EcoEA resource levels & bonus computation
+    emp::Ptr<EcoEAEngine> ecoea = nullptr;
 };
 
 ///< functions called to setup the world
@@ -304,16 +578,25 @@ void DiagWorld::Initialize()
   SetPopStruct_Mixed(true);
   SetSynchronousSystematics(true);
 
+  // threads shared by parallel population passes
+  pool = emp::NewPtr<ThreadPool>(config.THREAD_CNT());
+
   // stuff we need to initialize for the experiment
+  SetOutput();
   SetEvaluation();
   SetMutation();
+  SetAllocation();
+  // a resumed population is placed before systematics start tracking births
+  if(resume_from) {RestorePopulation();}
   SetDataTracking();
   SetSelection();
   // SetOnOffspringReady();
-  PopulateWorld();
+  if(resume_from) {RestoreTracking();}
+  else {PopulateWorld();}
 
   SetOnUpdate();
-  SetAutoMutate();
+  // batched reproduction mutates offspring before their births are registered
+  if(!config.MUTATE_BATCH()) {SetAutoMutate();}
   SnapshotConfig(config);
 
   std::cerr << "==========================================" << std::endl;
@@ -329,6 +612,9 @@ void DiagWorld::SetOnUpdate()
   // set up the evolutionary algorithm
   OnUpdate([this](size_t gen)
   {
+    // step 0: checkpoint boundary, every later random draw depends only on the state saved here
+    if(config.CHECKPOINT_INTERVAL() && !(gen % config.CHECKPOINT_INTERVAL())) {CheckpointStep(gen);}
+
     // step 0: reset all data collection variables
     ResetData();
 
@@ -346,16 +632,100 @@ void DiagWorld::SetOnUpdate()
 
     // step 4: reproduce and create new solutions
     ReproductionStep();
+
+    // phase times go out with the data rows
+    if(timer.IsOn() && (!(gen % config.DATA_INTERVAL()) || (gen == config.MAX_GENS()) || (gen <= 1))) {timer.WriteRows(timing_file, gen);}
   });
 
   std::cerr << "Finished setting the OnUpdate function! \n" << std::endl;
 }
 
+void DiagWorld::SetOutput()
+{
+  std::cerr << "------------------------------------------------" << std::endl;
+  std::cerr << "Setting output..." << std::endl;
+
+  if(config.ASYNC_OUTPUT())
+  {
+    writer = emp::NewPtr<AsyncWriter>(config.ASYNC_QUEUE());
+    data_out.SetWriter(writer);
+    phylodiversity_out.SetWriter(writer);
+    std::cerr << "Data files and binary snapshots written from a background thread" << std::endl;
+    // emp writes these itself, by path, on the generation thread
+    std::cerr << "CSV snapshots (SNAP_FORMAT 0) and systematics files are still written synchronously" << std::endl;
+  }
+
+  timer.SetMode(config.TIMING());
+  if(timer.IsOn())
+  {
+    // a resumed run keeps the rows before its checkpoint and writes its own beside them (folded in at the end of the run)
+    const std::string path = TimingPath() + (resume_from ? ".resume" : "");
+    if(resume_from) {ResumeCsv(TimingPath(), resume_hdr.update);}
+    timing_file.open(path, std::ios::trunc);
+    if(!timing_file) {std::cerr << "ERROR: UNABLE TO OPEN " << path << std::endl; timer.SetMode(0);}
+    else
+    {
+      timer.WriteHeader(timing_file);
+      std::cerr << "Phase timers on" << (timer.HasCycles() ? " (with cycle counter)" : "") << std::endl;
+    }
+  }
+
+  std::cerr << "Finished setting output! \n" << std::endl;
+}
+
 void DiagWorld::SetMutation()
 {
   std::cerr << "------------------------------------------------" << std::endl;
   std::cerr << "Setting mutation function..." << std::endl;
 
+  // every mutated gene is rounded to this precision
+  codec = GeneCodec(config.GENE_ROUNDING(), config.TARGET());
+  std::cerr << "Genes and scores stored as " << GENE_TYPE_NAME << std::endl;
+  if(codec.IsActive()) {std::cerr << "Mutated genes rounded to reduced precision (" << config.GENE_ROUNDING() << "), still stored as " << GENE_TYPE_NAME << std::endl;}
+
+  // population-wide pass: streams are reseeded from the world stream every generation
+  if(config.MUTATE_BATCH())
+  {
+    const size_t chunks = (config.POP_SIZE() + MUT_BATCH_ROWS - 1) / MUT_BATCH_ROWS;
+    for(size_t c = 0; c < chunks; ++c)
+    {
+      batch_random.emplace_back(1);
+      batch_kernels.emplace_back(config.MUTATE_PER(), config.MEAN(), config.STD(), config.TARGET());
+      batch_kernels.back().SetPrecision(codec);
+    }
+
+    std::cerr << "Batched mutation set (" << chunks << " streams, " << pool->GetThreadCnt() << " threads)!\n" << std::endl;
+    return;
+  }
+
+  // geometric skip kernel: only the mutated genes are visited (counter based streams always use it)
+  if(config.MUTATE_SKIP() || config.RNG_MODE() == 1)
+  {
+    mutator = emp::NewPtr<MutationKernel>(config.MUTATE_PER(), config.MEAN(), config.STD(), config.TARGET());
+    mutator->SetPrecision(codec);
+
+    SetMutFun([this](Org & org, emp::Random & random)
+    {
+      // quick checks
+      emp_assert(org.GetGenome().size() == config.OBJECTIVE_CNT());
+
+      size_t mcnt = 0;
+      if(config.RNG_MODE() == 1)
+      {
+        // births happen in parent order, so the birth index names the offspring
+        CounterRandom stream(run_seed, GetUpdate(), birth_cnt++, RngPurpose::MUTATION);
+        mcnt = mutator->Mutate(org.GetGenome(), stream);
+      }
+      else {mcnt = mutator->Mutate(org.GetGenome(), *random_ptr);}
+      org.SetMutated(mutator->GetChanged());
+
+      return mcnt;
+    });
+
+    std::cerr << "Geometric skip mutation function set!\n" << std::endl;
+    return;
+  }
+
   // set the mutation function
   SetMutFun([this](Org & org, emp::Random & random)
   {
@@ -391,6 +761,7 @@ void DiagWorld::SetMutation()
           genome[i] = genome[i] + mut;
         }
 
+        genome[i] = codec.Round(genome[i]);
         ++mcnt;
       }
     }
@@ -409,50 +780,29 @@ void DiagWorld::SetSelection()
   selection = emp::NewPtr<Selection>(random_ptr);
   std::cerr << "Created selection emp::Ptr" << std::endl;
 
-  switch (config.SELECTION())
+  // every selection event draws from its own stream, whatever thread or order it runs in
+  if(config.RNG_MODE() == 1)
   {
-    case 0: // mu lambda
-      MuLambda();
-      break;
-
-    case 1: // tournament
-      Tournament();
-      break;
-
-    case 2: // fitness sharing
-      FitnessSharing();
-      break;
-
-    case 3: // novelty search
-      NoveltySearch();
-      break;
-
-    case 4: // epsilon lexicase
-      EpsilonLexicase();
-      break;
-
-    case 5: // down sampled epsilon lexicase
-      DownSampledLexicase();
-      break;
-
-    case 6: // cohort epsilon lexicase selection
-      CohortLexicase();
-      break;
-
-    case 7: // novelty epsilon lexicase selection
-      NoveltyLexicase();
-      break;
+    selection->SetCounterStreams(run_seed);
+    std::cerr << "Selection events draw from counter based streams" << std::endl;
+  }
 
-    case 8:
-      EcoEA();
-      break;
+  // engine by name, or the one behind the SELECTION number
+  const std::string name = SelectionName(config);
 
-    default:
-      std::cerr << "ERROR UNKNOWN SELECTION CALL" << std::endl;
-      emp_assert(true);
-      break;
+  const EngineRegistry<sele_engine_t> & engines = SelectionEngines();
+  if(!engines.Has(name))
+  {
+    std::cerr << "ERROR UNKNOWN SELECTION CALL: " << (name.empty() ? std::to_string(config.SELECTION()) : name) << " (known:";
+    for(const auto & n : engines.Names()) {std::cerr << " " << n;}
+    std::cerr << ")" << std::endl;
+    emp_assert(false);
+    std::exit(EXIT_FAILURE);
   }
 
+  select_data = engines.Get(name)(*this);
+  std::cerr << "Selection engine: " << name << std::endl;
+
   std::cerr << "Finished setting the Selection function! \n" << std::endl;
 }
 
@@ -502,34 +852,44 @@ void DiagWorld::SetEvaluation()
   diagnostic = emp::NewPtr<Diagnostic>(target, config.CREDIT());
   std::cerr << "Created diagnostic emp::Ptr" << std::endl;
 
-  switch (config.DIAGNOSTIC())
-  {
-    case 0: // exploitation
-      Exploitation();
-      break;
-
-    case 1: // structured exploitation
-      StructuredExploitation();
-      break;
+  // engine by name, or the one behind the DIAGNOSTIC number
+  std::string name = config.DIAGNOSTIC_ENGINE();
+  if(name.empty() && config.DIAGNOSTIC() < DIAGNOSTIC_NAMES.size()) {name = DIAGNOSTIC_NAMES[config.DIAGNOSTIC()];}
+  const size_t diag = std::find(DIAGNOSTIC_NAMES.begin(), DIAGNOSTIC_NAMES.end(), name) - DIAGNOSTIC_NAMES.begin();
 
-    case 2: // strong ecology
-      StrongEcology();
-      break;
-
-    case 3: // exploration
-      Exploration();
-      break;
+  // compile time kernels for common objective counts (built in diagnostics only), dynamic ones otherwise
+  if(config.FIXED_KERNELS() && diag < DIAGNOSTIC_NAMES.size())
+  {
+    bool fixed = false;
+    switch (config.OBJECTIVE_CNT())
+    {
+      case 10: fixed = SetFixedEvaluation<10>(diag); break;
+      case 50: fixed = SetFixedEvaluation<50>(diag); break;
+      case 100: fixed = SetFixedEvaluation<100>(diag); break;
+      case 1000: fixed = SetFixedEvaluation<1000>(diag); break;
+      default: break;
+    }
 
-    case 4: // weak ecology
-      WeakEcology();
-      break;
+    if(fixed)
+    {
+      std::cerr << "Evaluation function set (fixed " << config.OBJECTIVE_CNT() << " objectives)!\n" <<std::endl;
+      return;
+    }
+  }
 
-    default: // error, unknown diganotic
-      std::cerr << "ERROR: UNKNOWN DIAGNOSTIC" << std::endl;
-      emp_assert(true);
-      break;
+  const EngineRegistry<diag_engine_t> & engines = DiagnosticEngines();
+  if(!engines.Has(name))
+  {
+    std::cerr << "ERROR: UNKNOWN DIAGNOSTIC: " << (name.empty() ? std::to_string(config.DIAGNOSTIC()) : name) << " (known:";
+    for(const auto & n : engines.Names()) {std::cerr << " " << n;}
+    std::cerr << ")" << std::endl;
+    emp_assert(false);
+    std::exit(EXIT_FAILURE);
   }
 
+  engines.Get(name)(*this);
+  std::cerr << "Diagnostic engine: " << name << std::endl;
+
   std::cerr << "Evaluation function set!\n" <<std::endl;
 }
 
@@ -556,12 +916,39 @@ void DiagWorld::SetDataTracking()
     return emp::ToString(taxon.GetInfo());
   }, "genotype", "Taxon Genotype");
 
+  // compacted trees need branch length aware distance and diversity nodes
   gen_sys_ptr->AddEvolutionaryDistinctivenessDataNode();
-  gen_sys_ptr->AddPairwiseDistanceDataNode();
-  gen_sys_ptr->AddPhylogeneticDiversityDataNode();
+  if(config.PHYLO_COMPACT())
+  {
+    gen_sys_ptr->AddCompactPairwiseDistanceDataNode();
+    gen_sys_ptr->AddCompactPhylogeneticDiversityDataNode();
+  }
+  else
+  {
+    gen_sys_ptr->AddPairwiseDistanceDataNode();
+    gen_sys_ptr->AddPhylogeneticDiversityDataNode();
+  }
+
+  // binary snapshots pack the same three columns
+  if(config.SNAP_FORMAT() == 1)
+  {
+    gen_snapshot = emp::NewPtr<gen_snapshot_t>(
+      [](const gen_taxon_t & taxon) { return taxon.GetData().GetFitness(); },
+      [](const gen_taxon_t & taxon) -> const genome_t & { return taxon.GetInfo(); },
+      [](const gen_taxon_t & taxon) -> const score_t & { return taxon.GetData().GetPhenotype(); },
+      config.OBJECTIVE_CNT(), config.OBJECTIVE_CNT()
+    );
+
+#ifndef DIA_SNAPSHOT_ZLIB
+    if(config.SNAP_COMPRESS()) {std::cerr << "WARNING: SNAP_COMPRESS needs DIA_SNAPSHOT_ZLIB, writing raw columns" << std::endl;}
+#endif
+  }
+
+  // resumed runs write systematics rows beside the file, they are appended to it at the end of the run
+  const std::string sys_tail = resume_from ? ".resume" : "";
 
   AddSystematics(gen_sys_ptr, "genotype");
-  SetupSystematicsFile("genotype", config.OUTPUT_DIR() + "genotype_systematics.csv").SetTimingRepeat(config.DATA_INTERVAL());
+  SetupSystematicsFile("genotype", SysFilePath("genotype") + sys_tail).SetTimingRepeat(config.DATA_INTERVAL());
 
 
   // -- PHENOTYPE SYSTEMATICS --
@@ -579,11 +966,19 @@ void DiagWorld::SetDataTracking()
   );
 
   phen_sys_ptr->AddEvolutionaryDistinctivenessDataNode();
-  phen_sys_ptr->AddPairwiseDistanceDataNode();
-  phen_sys_ptr->AddPhylogeneticDiversityDataNode();
+  if(config.PHYLO_COMPACT())
+  {
+    phen_sys_ptr->AddCompactPairwiseDistanceDataNode();
+    phen_sys_ptr->AddCompactPhylogeneticDiversityDataNode();
+  }
+  else
+  {
+    phen_sys_ptr->AddPairwiseDistanceDataNode();
+    phen_sys_ptr->AddPhylogeneticDiversityDataNode();
+  }
 
   AddSystematics(phen_sys_ptr, "phenotype");
-  SetupSystematicsFile("phenotype", config.OUTPUT_DIR() + "phenotype_systematics.csv").SetTimingRepeat(config.DATA_INTERVAL());
+  SetupSystematicsFile("phenotype", SysFilePath("phenotype") + sys_tail).SetTimingRepeat(config.DATA_INTERVAL());
 
   // -- PHYLODIVERSITY DATA FILE --
   phylodiversity_file.AddVar(update, "generation", "Generation");
@@ -602,6 +997,9 @@ void DiagWorld::SetDataTracking()
   pop_fit.New(); pop_opti.New(); pnt_fit.New(); pnt_opti.New();
   std::cerr << "Nodes initialized!" << std::endl;
 
+  // the data file reads every data node
+  data_stats |= STAT_POP_NODES | STAT_PNT_NODES;
+
   // track population aggregate score stats: average, variance, min, max
   data_file.AddMean(*pop_fit, "pop_fit_avg", "Population average aggregate performance.");
   data_file.AddVariance(*pop_fit, "pop_fit_var", "Population variance aggregate performance.");
@@ -635,26 +1033,31 @@ void DiagWorld::SetDataTracking()
   }, "gen", "Current generation at!");
 
   // unique optimized objectives count
+  data_stats |= STAT_UNI_OBJ;
   data_file.AddFun<size_t>([this]()
   {
-    return UniqueObjective();
+    TrackStats(STAT_UNI_OBJ);
+    return uni_obj;
   }, "pop_uni_obj", "Number of unique optimized traits per generation!");
 
     // unique starting positions
+  data_stats |= STAT_UNI_START;
   data_file.AddFun<size_t>([this]()
   {
-    return FindUniqueStart();
+    TrackStats(STAT_UNI_START);
+    return uni_start;
   }, "uni_str_pos", "Number of unique starting positions in the population!");
 
   // count of common solution in the population
+  data_stats |= STAT_COMMON;
   data_file.AddFun<size_t>([this]()
   {
     // quick checks
+    const size_t pos = GetCommonPos();
     emp_assert(0 < common.size());
-    emp_assert(comm_pos != config.POP_SIZE());
 
     // find iterator to common org
-    const auto it = common.find(comm_pos);
+    const auto it = common.find(pos);
     emp_assert(it != common.end());
     emp_assert(0 < it->second.size());
 
@@ -662,13 +1065,13 @@ void DiagWorld::SetDataTracking()
   }, "com_sol_cnt", "Count of genetically common solution!");
 
   // elite solution aggregate performance
+  data_stats |= STAT_ELITE;
   data_file.AddFun<double>([this]()
   {
     // quick checks
-    emp_assert(elite_pos != config.POP_SIZE());
     emp_assert(pop.size() == config.POP_SIZE());
 
-    Org & org = *pop[elite_pos];
+    Org & org = *pop[GetElitePos()];
 
     return org.GetAggregate();
   }, "ele_agg_per", "Elite solution aggregate performance!");
@@ -677,10 +1080,9 @@ void DiagWorld::SetDataTracking()
   data_file.AddFun<size_t>([this]()
   {
     // quick checks
-    emp_assert(elite_pos != config.POP_SIZE());
     emp_assert(pop.size() == config.POP_SIZE());
 
-    Org & org = *pop[elite_pos];
+    Org & org = *pop[GetElitePos()];
 
     return org.GetCount();
   }, "ele_opt_cnt", "Elite solution optimized objective count!");
@@ -689,10 +1091,9 @@ void DiagWorld::SetDataTracking()
   data_file.AddFun<double>([this]()
   {
     // quick checks
-    emp_assert(comm_pos != config.POP_SIZE());
     emp_assert(pop.size() == config.POP_SIZE());
 
-    Org & org = *pop[comm_pos];
+    Org & org = *pop[GetCommonPos()];
 
     return org.GetAggregate();
   }, "com_agg_per", "Common solution aggregate performance!");
@@ -701,22 +1102,21 @@ void DiagWorld::SetDataTracking()
   data_file.AddFun<size_t>([this]()
   {
     // quick checks
-    emp_assert(comm_pos != config.POP_SIZE());
     emp_assert(pop.size() == config.POP_SIZE());
 
-    Org & org = *pop[comm_pos];
+    Org & org = *pop[GetCommonPos()];
 
     return org.GetCount();
   }, "com_opt_cnt", "Common solution optimized objective count!");
 
   // optimized solution aggregate performance
+  data_stats |= STAT_OPTIMAL;
   data_file.AddFun<double>([this]()
   {
     // quick checks
-    emp_assert(opti_pos != config.POP_SIZE());
     emp_assert(pop.size() == config.POP_SIZE());
 
-    Org & org = *pop[opti_pos];
+    Org & org = *pop[GetOptimalPos()];
 
     return org.GetAggregate();
   }, "opt_agg_per", "Otpimal solution aggregate performance");
@@ -725,10 +1125,9 @@ void DiagWorld::SetDataTracking()
   data_file.AddFun<size_t>([this]()
   {
     // quick checks
-    emp_assert(opti_pos != config.POP_SIZE());
     emp_assert(pop.size() == config.POP_SIZE());
 
-    Org & org = *pop[opti_pos];
+    Org & org = *pop[GetOptimalPos()];
 
     return org.GetCount();
   }, "opt_obj_cnt", "Otpimal solution aggregate performance");
@@ -753,6 +1152,7 @@ void DiagWorld::SetDataTracking()
   data_file.AddFun<double>([this]()
   {
     // quick checks
+    TrackStats(STAT_POP_NODES | STAT_PNT_NODES);
     emp_assert(pop_fit->GetCount() == config.POP_SIZE());
     emp_assert(pnt_fit->GetCount() == config.POP_SIZE());
 
@@ -769,6 +1169,7 @@ void DiagWorld::SetDataTracking()
   data_file.AddFun<double>([this]()
   {
     // quick checks
+    TrackStats(STAT_POP_NODES | STAT_PNT_NODES);
     emp_assert(pop_fit->GetCount() == config.POP_SIZE());
     emp_assert(pnt_fit->GetCount() == config.POP_SIZE());
 
@@ -780,11 +1181,53 @@ void DiagWorld::SetDataTracking()
     return pop / pnt;
   }, "sel_var", "Selection pressure applied by selection scheme!");
 
+  // organism allocation statistics (confirm steady state runs stay off the heap)
+  if(config.ORG_ALLOC())
+  {
+    data_file.AddFun<size_t>([]()
+    {
+      return OrgArena::Local().GetStats().heap;
+    }, "org_heap", "Organisms (or pool chunks) allocated from the heap so far!");
+
+    data_file.AddFun<size_t>([]()
+    {
+      return OrgArena::Local().GetStats().reused;
+    }, "org_reused", "Organisms placed in recycled storage so far!");
+
+    data_file.AddFun<size_t>([]()
+    {
+      return OrgArena::Local().GetStats().vec_heap;
+    }, "vec_heap", "Organism vectors that allocated their own buffer so far!");
+  }
+
   data_file.PrintHeaderKeys();
 
   std::cerr << "Finished setting data tracking!\n" << std::endl;
 }
 
+void DiagWorld::SetAllocation()
+{
+  // where organisms are allocated from here on
+  switch (config.ORG_ALLOC())
+  {
+    case 0: // heap
+      break;
+
+    case 1: // double buffered generations
+      OrgArena::Local().Reserve(config.POP_SIZE(), sizeof(Org));
+      break;
+
+    case 2: // recycling pool, room for two generations
+      OrgArena::Local().ReservePool(2 * config.POP_SIZE(), sizeof(Org), config.OBJECTIVE_CNT());
+      break;
+
+    default:
+      std::cerr << "ERROR UNKNOWN ORG_ALLOC" << std::endl;
+      emp_assert(false);
+      break;
+  }
+}
+
 void DiagWorld::PopulateWorld()
 {
   std::cerr << "------------------------------------------" << std::endl;
@@ -811,6 +1254,8 @@ void DiagWorld::PopulateWorld()
   phen_taxon->GetData().RecordFitness(ancestor.GetAggregate());
   phen_taxon->GetData().RecordPhenotype(ancestor.GetScore());
 
+  // ancestor keeps the first buffer, the population is born into the second
+  if(config.ORG_ALLOC() == 1) {OrgArena::Local().Swap();}
   DoBirth(ancestor.GetGenome(), 0, config.POP_SIZE());
 
   Update();
@@ -819,17 +1264,161 @@ void DiagWorld::PopulateWorld()
 }
 
 
+///< checkpoint & restart
+
+void DiagWorld::ReadCheckpoint()
+{
+  const std::string path = config.OUTPUT_DIR() + "checkpoint.bin";
+  emp::Ptr<CheckpointReader> in = emp::NewPtr<CheckpointReader>();
+
+  if(!in->ReadFile(path))
+  {
+    std::cerr << "No checkpoint at " << path << ", starting a fresh run" << std::endl;
+    in.Delete();
+    return;
+  }
+
+  resume_hdr = in->Get<CheckpointHeader>();
+  if(!in->Ok() || !resume_hdr.IsValid() || resume_hdr.pop_size != config.POP_SIZE() || resume_hdr.objectives != config.OBJECTIVE_CNT())
+  {
+    std::cerr << "ERROR: CHECKPOINT " << path << " DOES NOT MATCH THIS CONFIGURATION, starting a fresh run" << std::endl;
+    in.Delete();
+    return;
+  }
+
+  // systematics files are reopened (and truncated) by name, keep their rows before the checkpoint
+  ResumeCsv(SysFilePath("genotype"), resume_hdr.update);
+  ResumeCsv(SysFilePath("phenotype"), resume_hdr.update);
+
+  resume_from = in;
+  run_seed = resume_hdr.seed;
+  std::cerr << "Resuming from " << path << " at update " << resume_hdr.update << std::endl;
+}
+
+void DiagWorld::RestorePopulation()
+{
+  std::cerr << "------------------------------------------" << std::endl;
+  std::cerr << "Restoring checkpointed population..." << std::endl;
+  emp_assert(resume_from);
+
+  // positions are filled in order, matching the saved genomes
+  genome_t genome(config.OBJECTIVE_CNT());
+  for(size_t i = 0; i < config.POP_SIZE(); ++i)
+  {
+    resume_from->GetRaw(genome.data(), genome.size());
+    Inject(genome, 1);
+  }
+  emp_assert(pop.size() == config.POP_SIZE());
+
+  std::cerr << "Population restored!" << std::endl;
+}
+
+void DiagWorld::RestoreTracking()
+{
+  std::cerr << "------------------------------------------" << std::endl;
+  std::cerr << "Restoring checkpointed state..." << std::endl;
+  emp_assert(resume_from);
+
+  bool ok = gen_sys_ptr->Load(*resume_from) && phen_sys_ptr->Load(*resume_from);
+
+  // resources only exist under EcoEA, the checkpoint holds none otherwise
+  const emp::vector<double> amounts = resume_from->GetVec();
+  ok = ok && resume_from->Ok() && resume_from->Done() && amounts.size() == (ecoea ? ecoea->GetObjectiveCnt() : 0);
+  if(ok && ecoea) {ecoea->SetLevels(amounts);}
+
+  // data files continue from where the checkpoint left them
+  ok = ok && data_out.Resume(resume_hdr.data_bytes) && phylodiversity_out.Resume(resume_hdr.phylo_bytes);
+
+  if(!ok)
+  {
+    std::cerr << "ERROR: CHECKPOINT COULD NOT BE RESTORED" << std::endl;
+    emp_assert(false);
+  }
+
+  // next update is the one the checkpoint was taken at
+  update = resume_hdr.update;
+  resume_at = resume_hdr.update;
+  snap_cnt = resume_hdr.snap_cnt;
+  snap_full = true;
+
+  resume_from.Delete();
+  resume_from = nullptr;
+
+  std::cerr << "Resumed at update " << update << "!" << std::endl;
+}
+
+void DiagWorld::CheckpointStep(const size_t gen)
+{
+  DIA_PHASE(timer, Phase::CHECKPOINT);
+
+  // counter based streams draw nothing from random_ptr after setup, so there is no generator state to restart
+  // shared emp::Random state cannot be saved, so its stream restarts from a seed keyed by the update:
+  // the run resumes exactly, but it is not the run CHECKPOINT_INTERVAL = 0 gives at the same SEED
+  if(config.RNG_MODE() != 1)
+  {
+    CounterRandom stream(run_seed, gen, 0, RngPurpose::CHECKPOINT);
+    random_ptr->ResetSeed(static_cast<int>(stream.GetUInt(MUT_SEED_MAX)) + 1);
+  }
+
+  // the checkpoint we resumed from already holds this update
+  if(gen != resume_at) {WriteCheckpoint();}
+}
+
+void DiagWorld::WriteCheckpoint()
+{
+  // recorded data file sizes must already be on disk
+  if(writer) {writer->Flush();}
+
+  CheckpointHeader hdr;
+  hdr.update = GetUpdate();
+  hdr.seed = run_seed;
+  hdr.pop_size = pop.size();
+  hdr.objectives = config.OBJECTIVE_CNT();
+  hdr.data_bytes = data_out.GetWritten();
+  hdr.phylo_bytes = phylodiversity_out.GetWritten();
+  hdr.snap_cnt = snap_cnt;
+
+  CheckpointWriter out;
+  out.Put(hdr);
+
+  for(size_t i = 0; i < pop.size(); ++i)
+  {
+    const genome_t & genome = pop[i]->GetGenome();
+    emp_assert(genome.size() == config.OBJECTIVE_CNT());
+    out.PutRaw(genome.data(), genome.size());
+  }
+
+  gen_sys_ptr->Save(out);
+  phen_sys_ptr->Save(out);
+
+  out.PutVec(ecoea ? ecoea->GetLevels() : emp::vector<double>());
+
+  if(out.WriteFile(config.OUTPUT_DIR() + "checkpoint.bin"))
+  {
+    std::cerr << "Checkpoint written at update " << hdr.update << " (" << out.GetSize() << " bytes)" << std::endl;
+  }
+}
+
+
 ///< principle steps during an evolutionary run
 
 void DiagWorld::ResetData()
 {
+  DIA_PHASE(timer, Phase::RESET);
+
+  // last generation died at the end of the previous update, its buffer takes this generation's births
+  if(config.ORG_ALLOC() == 1) {OrgArena::Local().Swap();}
+
   // reset all data nodes
   pop_fit->Reset();
   pop_opti->Reset();
   pnt_fit->Reset();
   pnt_opti->Reset();
 
-  // reset all positon ids
+  stat_done = STAT_NONE;
+  birth_cnt = 0;
+
+  // reset all positon ids (POP_SIZE marks not yet computed)
   elite_pos = config.POP_SIZE();
   comm_pos = config.POP_SIZE();
   opti_pos = config.POP_SIZE();
@@ -842,12 +1431,15 @@ void DiagWorld::ResetData()
 
 void DiagWorld::EvaluationStep()
 {
+  DIA_PHASE(timer, Phase::EVALUATION);
+
   // quick checks
   emp_assert(fit_vec.size() == 0); emp_assert(0 < pop.size());
   emp_assert(pop.size() == config.POP_SIZE());
 
-  // iterate through the world and populate fitness vector
-  fit_vec.resize(config.POP_SIZE());
+  // iterate through the world and populate fitness vector (if the selection engine reads it)
+  const bool aggregate = select_data & DATA_AGGREGATE;
+  if(aggregate) {fit_vec.resize(config.POP_SIZE());}
   for(size_t i = 0; i < pop.size(); ++i)
   {
     Org & org = *(pop[i]);
@@ -855,7 +1447,8 @@ void DiagWorld::EvaluationStep()
     org.Reset();
 
     // no evaluate needed if offspring is a clone
-    fit_vec[i] = evaluate(org);
+    const double fit = evaluate(org);
+    if(aggregate) {fit_vec[i] = fit;}
 
     // Record fitness/phenotype information for systematics tracking
     emp::Ptr<gen_taxon_t> gen_taxon = gen_sys_ptr->GetTaxonAt(i);
@@ -870,12 +1463,28 @@ void DiagWorld::EvaluationStep()
 
 void DiagWorld::SelectionStep()
 {
+  DIA_PHASE(timer, Phase::SELECTION);
+
   // quick checks
   emp_assert(parent_vec.size() == 0); emp_assert(0 < pop.size());
   emp_assert(pop.size() == config.POP_SIZE());
 
+  // selection events of this generation are numbered from 0 (counter based streams)
+  selection->SetEvent(GetUpdate());
+
+  // build only the inputs the engine asked for
+  SelectionInputs in;
+  if(select_data & DATA_AGGREGATE) {in.aggregate = &fit_vec;}
+  if(select_data & (DATA_SCORES | DATA_NOVELTY)) {sel_scores = PopFitMat(); in.scores = &sel_scores;}
+  if(select_data & DATA_GENOMES) {sel_genomes = PopGenomes(); in.genomes = &sel_genomes;}
+  if(select_data & DATA_NOVELTY)
+  {
+    sel_novelty = selection->LexicaseNoveltyFit(sel_scores, config.NOVEL_K(), config.OBJECTIVE_CNT());
+    in.novelty = &sel_novelty;
+  }
+
   // store parents
-  auto parents = select();
+  auto parents = select(in);
   emp_assert(parents.size() == config.POP_SIZE());
 
   parent_vec.resize(config.POP_SIZE());
@@ -884,76 +1493,168 @@ void DiagWorld::SelectionStep()
 
 void DiagWorld::RecordData()
 {
-  /// Add data to all nodes
-
-  // get pop data
-  emp_assert(pop.size() == config.POP_SIZE());
-  for(size_t i = 0; i < pop.size(); ++i)
-  {
-    Org & org = *pop[i];
-    pop_fit->Add(org.GetAggregate());
-    pop_opti->Add(org.GetCount());
-  }
-  emp_assert(pop_fit->GetCount() == config.POP_SIZE());
-  emp_assert(pop_opti->GetCount() == config.POP_SIZE());
-
-  // get parent data
-  emp_assert(parent_vec.size() == config.POP_SIZE());
-  for(size_t i = 0; i < parent_vec.size(); ++i)
-  {
-    Org & org = *pop[parent_vec[i]];
-    pnt_fit->Add(org.GetAggregate());
-    pnt_opti->Add(org.GetCount());
-  }
-  emp_assert(pnt_fit->GetCount() == config.POP_SIZE());
-  emp_assert(pnt_opti->GetCount() == config.POP_SIZE());
-
-  /// get all position ids
+  DIA_PHASE(timer, Phase::RECORD);
 
-  elite_pos = FindElite();
-  emp_assert(elite_pos != config.POP_SIZE());
-
-  comm_pos = FindCommon();
-  emp_assert(comm_pos != config.POP_SIZE());
-
-  opti_pos = FindOptimized();
-  emp_assert(opti_pos != config.POP_SIZE());
+  /// statistics are computed on demand by whoever reads them below
 
   /// fill vectors & map
-  emp_assert(fit_vec.size() == config.POP_SIZE()); // should be set already
+  emp_assert(!(select_data & DATA_AGGREGATE) || fit_vec.size() == config.POP_SIZE()); // should be set already
   emp_assert(parent_vec.size() == config.POP_SIZE()); // should be set already
-  emp_assert(0 < common.size());  // should already be set in FindCommon
 
   /// update the file
   if ( !(GetUpdate() % config.DATA_INTERVAL()) || (GetUpdate() == config.MAX_GENS()) || (GetUpdate() <= 1)) {
+    // everything the data file declared, each computed once
+    TrackStats(data_stats);
+
+    DIA_PHASE(timer, Phase::FILE_WRITE);
     data_file.Update();
     phylodiversity_file.Update();
+    data_out.Drain();
+    phylodiversity_out.Drain();
   }
 
-  if ( !(GetUpdate() % config.PRINT_INTERVAL()) || (GetUpdate() == config.MAX_GENS()) || (GetUpdate() <= 1)) {
-    // output this so we know where we are in terms of generations and fitness
+  if (config.PRINT_INTERVAL() && ( !(GetUpdate() % config.PRINT_INTERVAL()) || (GetUpdate() == config.MAX_GENS()) || (GetUpdate() <= 1))) {
+    // output this so we know where we are in terms of generations and fitness (reuses the data file's pass)
+    TrackStats(PRINT_STATS);
     Org & org = *pop[elite_pos];
     Org & opt = *pop[opti_pos];
-    std::cout << "gen=" << GetUpdate() << ", max_fit=" << org.GetAggregate()  << ", max_opt=" << opt.GetCount() << std::endl;
+    *progress << "gen=" << GetUpdate() << ", max_fit=" << org.GetAggregate()  << ", max_opt=" << opt.GetCount() << std::endl;
   }
 
   // snapshot the phylogeny
   if ( !(GetUpdate() % config.SNAP_INTERVAL()) || (GetUpdate() == config.MAX_GENS()) ) {
-    gen_sys_ptr->Snapshot(config.OUTPUT_DIR() + "phylo_" + emp::to_string(GetUpdate()) + ".csv");
+    DIA_PHASE(timer, Phase::SNAPSHOT);
+    if(config.SNAP_FORMAT() == 1 && config.SNAP_DELTA()) {
+      // incremental snapshots still write a full checkpoint every SNAP_DELTA snapshots (and right after a resume)
+      const bool full = snap_full || !(snap_cnt % config.SNAP_DELTA());
+      snap_full = false;
+      const auto bytes = gen_snapshot->SerializeDelta(gen_sys_ptr->GetTaxa(), GetUpdate(), config.SNAP_COMPRESS(), full);
+      WriteSnapshot(config.OUTPUT_DIR() + "phylo_" + emp::to_string(GetUpdate()) + ".bin", bytes);
+      ++snap_cnt;
+    }
+    else if(config.SNAP_FORMAT() == 1) {
+      const auto bytes = gen_snapshot->Serialize(gen_sys_ptr->GetTaxa(), GetUpdate(), config.SNAP_COMPRESS());
+      WriteSnapshot(config.OUTPUT_DIR() + "phylo_" + emp::to_string(GetUpdate()) + ".bin", bytes);
+    }
+    else {
+      gen_sys_ptr->Snapshot(config.OUTPUT_DIR() + "phylo_" + emp::to_string(GetUpdate()) + ".csv");
+    }
   }
 
+  // collapse extinct unifurcating ancestors to keep tree memory bounded
+  if (config.PHYLO_COMPACT() && !(GetUpdate() % config.PHYLO_COMPACT())) {
+    gen_sys_ptr->Compact();
+    phen_sys_ptr->Compact();
+  }
 }
 
 void DiagWorld::ReproductionStep()
 {
+  DIA_PHASE(timer, Phase::REPRODUCTION);
+
   // quick checks
   emp_assert(parent_vec.size() == config.POP_SIZE());
   emp_assert(pop.size() == config.POP_SIZE());
 
+  if(config.MUTATE_BATCH()) {BatchReproductionStep(); return;}
+
   // go through parent ids and do births
   for(auto & id : parent_vec){DoBirth(GetGenomeAt(id), id);}
 }
 
+void DiagWorld::BatchReproductionStep()
+{
+  // quick checks
+  emp_assert(parent_vec.size() == config.POP_SIZE());
+  emp_assert(batch_random.size() == batch_kernels.size()); emp_assert(0 < batch_kernels.size());
+
+  const size_t M = config.OBJECTIVE_CNT();
+  const size_t N = parent_vec.size();
+
+  // step 1: copy every parent genome into the contiguous offspring block
+  batch_genomes.resize(N * M);
+  for(size_t i = 0; i < N; ++i)
+  {
+    const genome_t & genome = GetGenomeAt(parent_vec[i]);
+    emp_assert(genome.size() == M);
+    std::copy(genome.begin(), genome.end(), batch_genomes.begin() + i * M);
+  }
+
+  // step 2: one stream per chunk of rows, or per offspring with counter based streams (results do not depend on THREAD_CNT)
+  const bool counter = config.RNG_MODE() == 1;
+  const uint64_t seed = run_seed;
+  const size_t gen = GetUpdate();
+  if(!counter) {for(auto & random : batch_random) {random.ResetSeed(static_cast<int>(random_ptr->GetUInt(MUT_SEED_MAX)) + 1);}}
+
+  pool->ParallelFor(batch_kernels.size(), [this, M, N, counter, seed, gen](size_t c)
+  {
+    const size_t end = std::min(N, (c + 1) * MUT_BATCH_ROWS);
+    for(size_t i = c * MUT_BATCH_ROWS; i < end; ++i)
+    {
+      if(counter)
+      {
+        CounterRandom stream(seed, gen, i, RngPurpose::MUTATION);
+        batch_kernels[c].Mutate(batch_genomes.data() + i * M, M, stream);
+      }
+      else {batch_kernels[c].Mutate(batch_genomes.data() + i * M, M, batch_random[c]);}
+    }
+  });
+
+  // step 3: register births with the world and systematics
+  genome_t genome(M);
+  for(size_t i = 0; i < N; ++i)
+  {
+    std::copy(batch_genomes.begin() + i * M, batch_genomes.begin() + (i + 1) * M, genome.begin());
+    DoBirth(genome, parent_vec[i]);
+  }
+}
+
+
+///< engine registries
+
+EngineRegistry<DiagWorld::sele_engine_t> & DiagWorld::SelectionEngines()
+{
+  static EngineRegistry<sele_engine_t> engines = []()
+  {
+    // built in schemes, in SELECTION order
+    EngineRegistry<sele_engine_t> reg;
+    reg.Add("mu_lambda", [](DiagWorld & w) {w.MuLambda(); return size_t(DATA_AGGREGATE);});
+    reg.Add("tournament", [](DiagWorld & w) {w.Tournament(); return size_t(DATA_AGGREGATE);});
+    reg.Add("fitness_sharing", [](DiagWorld & w) {w.FitnessSharing(); return size_t(DATA_AGGREGATE | DATA_GENOMES);});
+    reg.Add("novelty", [](DiagWorld & w) {w.NoveltySearch(); return size_t(DATA_AGGREGATE);});
+    reg.Add("lexicase", [](DiagWorld & w) {w.EpsilonLexicase(); return size_t(DATA_SCORES);});
+    // gathers only its sampled columns
+    reg.Add("ds_lexicase", [](DiagWorld & w) {w.DownSampledLexicase(); return size_t(DATA_NONE);});
+    // parallel cohorts gather their own submatrices
+    reg.Add("cohort_lexicase", [](DiagWorld & w) {w.CohortLexicase(); return size_t(w.config.COH_LEX_PARALLEL() ? DATA_NONE : DATA_SCORES);});
+    reg.Add("novelty_lexicase", [](DiagWorld & w) {w.NoveltyLexicase(); return size_t(DATA_NOVELTY);});
+    // copies scores into its own flat matrix
+    reg.Add("ecoea", [](DiagWorld & w) {w.EcoEA(); return size_t(DATA_NONE);});
+    emp_assert(reg.Names().size() == SELECTION_NAMES.size());
+    return reg;
+  }();
+
+  return engines;
+}
+
+EngineRegistry<DiagWorld::diag_engine_t> & DiagWorld::DiagnosticEngines()
+{
+  static EngineRegistry<diag_engine_t> engines = []()
+  {
+    // built in diagnostics, in DIAGNOSTIC order
+    EngineRegistry<diag_engine_t> reg;
+    reg.Add("exploitation", [](DiagWorld & w) {w.Exploitation();});
+    reg.Add("struct_exploitation", [](DiagWorld & w) {w.StructuredExploitation();});
+    reg.Add("strong_ecology", [](DiagWorld & w) {w.StrongEcology();});
+    reg.Add("exploration", [](DiagWorld & w) {w.Exploration();});
+    reg.Add("weak_ecology", [](DiagWorld & w) {w.WeakEcology();});
+    emp_assert(reg.Names().size() == DIAGNOSTIC_NAMES.size());
+    return reg;
+  }();
+
+  return engines;
+}
+
 
 ///< selection scheme implementations
 
@@ -962,14 +1663,14 @@ void DiagWorld::MuLambda()
   std::cerr << "Setting selection scheme: MuLambda" << std::endl;
 
   // set select lambda to mu lambda selection
-  select = [this]()
+  select = [this](const SelectionInputs & in)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
-    emp_assert(0 < pop.size()); emp_assert(fit_vec.size() == config.POP_SIZE());
+    emp_assert(0 < pop.size()); emp_assert(in.aggregate); emp_assert(in.aggregate->size() == config.POP_SIZE());
 
     // group population by fitness
-    fitgp_t group = selection->FitnessGroup(fit_vec);
+    fitgp_t group = selection->FitnessGroup(*in.aggregate);
 
     return selection->MLSelect(config.MU(), config.POP_SIZE(), group);
   };
@@ -981,19 +1682,22 @@ void DiagWorld::Tournament()
 {
   std::cerr << "Setting selection scheme: Tournament" << std::endl;
 
-  select = [this]()
+  select = [this](const SelectionInputs & in)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
-    emp_assert(0 < pop.size()); emp_assert(fit_vec.size() == config.POP_SIZE());
+    emp_assert(0 < pop.size()); emp_assert(in.aggregate); emp_assert(in.aggregate->size() == config.POP_SIZE());
 
     // will hold parent ids + get pop agg score values
     ids_t parent(pop.size());
 
+    // all tournaments drawn in one pass
+    if(config.TOUR_BATCH()) {return selection->TournamentBatch(pop.size(), config.TOUR_SIZE(), *in.aggregate);}
+
     // get pop size amount of parents
     for(size_t i = 0; i < parent.size(); ++i)
     {
-      parent[i] = selection->Tournament(config.TOUR_SIZE(), fit_vec);
+      parent[i] = selection->Tournament(config.TOUR_SIZE(), *in.aggregate);
     }
 
     return parent;
@@ -1019,18 +1723,23 @@ void DiagWorld::FitnessSharing()
   std::cerr << "SIGMA=" << SIGMA << std::endl;
 
 
-  select = [this]()
+  select = [this](const SelectionInputs & in)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
-    emp_assert(0 < pop.size()); emp_assert(fit_vec.size() == config.POP_SIZE());
+    emp_assert(0 < pop.size()); emp_assert(in.aggregate); emp_assert(in.aggregate->size() == config.POP_SIZE());
     emp_assert(0 <= SIGMA);
 
-    gmatrix_t genomes = PopGenomes();
+    emp_assert(in.genomes);
+    const gmatrix_t & genomes = *in.genomes;
 
     // generate distance matrix + fitness transformation
-    fmatrix_t dist_mat = selection->SimilarityMatrix(genomes, config.PNORM_EXP());
-    score_t tscore = selection->FitnessSharing(dist_mat, fit_vec, config.FIT_ALPHA(), SIGMA);
+    dmatrix_t dist_mat;
+    {DIA_PHASE(timer, Phase::SIMILARITY); dist_mat = selection->SimilarityMatrix(genomes, config.PNORM_EXP());}
+    fit_t tscore = selection->FitnessSharing(dist_mat, *in.aggregate, config.FIT_ALPHA(), SIGMA);
+
+    // all tournaments drawn in one pass
+    if(config.TOUR_BATCH()) {return selection->TournamentBatch(pop.size(), config.TOUR_SIZE(), tscore);}
 
     // select parent ids
     ids_t parent(pop.size());
@@ -1051,17 +1760,21 @@ void DiagWorld::NoveltySearch()
   std::cerr << "Setting selection scheme: NoveltySearch" << std::endl;
   std::cerr << "Tournament size for novelty: " << config.TOUR_SIZE() << std::endl;
 
-  select = [this]()
+  select = [this](const SelectionInputs & in)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
-    emp_assert(0 < pop.size()); emp_assert(fit_vec.size() == config.POP_SIZE());
+    emp_assert(0 < pop.size()); emp_assert(in.aggregate); emp_assert(in.aggregate->size() == config.POP_SIZE());
 
     // generate nearest neighbor pop structure
-    neigh_t neighborhood = selection->FitNearestN(fit_vec, config.NOVEL_K());
+    neigh_t neighborhood;
+    {DIA_PHASE(timer, Phase::NEAREST); neighborhood = selection->FitNearestN(*in.aggregate, config.NOVEL_K());}
 
     // transform original fitness into novelty fitness
-    score_t tscore = selection->Novelty(fit_vec, neighborhood, config.NOVEL_K());
+    fit_t tscore = selection->Novelty(*in.aggregate, neighborhood, config.NOVEL_K());
+
+    // all tournaments drawn in one pass
+    if(config.TOUR_BATCH()) {return selection->TournamentBatch(pop.size(), config.TOUR_SIZE(), tscore);}
 
     // select parent ids
     ids_t parent(pop.size());
@@ -1081,18 +1794,27 @@ void DiagWorld::EpsilonLexicase()
 {
   std::cerr << "Setting selection scheme: EpsilonLexicase" << std::endl;
 
-  select = [this]()
+  select = [this](const SelectionInputs & in)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
     emp_assert(0 < pop.size());
 
     // fitness matrix
-    fmatrix_t matrix = PopFitMat();
+    emp_assert(in.scores);
+    const fmatrix_t & matrix = *in.scores;
 
     // select parent ids
     ids_t parent(pop.size());
 
+    // events start from the reduced, weighted rows
+    if(config.LEX_REDUCE())
+    {
+      const Selection::LexPool reduced = selection->LexReduce(matrix, config.LEX_EPS(), config.OBJECTIVE_CNT(), config.LEX_REDUCE() == 1);
+      for(size_t i = 0; i < parent.size(); ++i) {parent[i] = selection->EpsiLexicase(reduced, config.LEX_EPS());}
+      return parent;
+    }
+
     for(size_t i = 0; i < parent.size(); ++i)
     {
       parent[i] = selection->EpsiLexicase(matrix, config.LEX_EPS(), config.OBJECTIVE_CNT());
@@ -1108,25 +1830,33 @@ void DiagWorld::DownSampledLexicase()
 {
   std::cerr << "Setting selection scheme: DownSampledLexicase" << std::endl;
 
-  select = [this]()
+  select = [this](const SelectionInputs &)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
     emp_assert(0 < pop.size()); emp_assert(0 < config.DSLEX_PROP());
 
-    // fitness matrix
-    fmatrix_t matrix = PopFitMat();
-
     // select parent ids
     ids_t parent(pop.size());
 
     // create subset of testcases to use for downsampled lexicase
     size_t subset = (double) config.OBJECTIVE_CNT() * config.DSLEX_PROP();
-    ids_t test_cases = emp::Choose(*random_ptr, config.OBJECTIVE_CNT(), subset);
+    ids_t test_cases = selection->DrawCases(config.OBJECTIVE_CNT(), subset);
+
+    // orgs identical (or dominated) on the sampled testcases are reduced away, rows gathered straight from the scores
+    if(config.LEX_REDUCE())
+    {
+      const Selection::LexPool reduced = selection->LexReduce(PopSampleRows(test_cases), config.LEX_EPS(), test_cases.size(), config.LEX_REDUCE() == 1);
+      for(size_t i = 0; i < parent.size(); ++i) {parent[i] = selection->EpsiLexicase(reduced, config.LEX_EPS());}
+      return parent;
+    }
+
+    // fitness matrix, sampled testcases only (gathered once per generation)
+    const score_t matrix = PopSampleMat(test_cases);
 
     for(size_t i = 0; i < parent.size(); ++i)
     {
-      parent[i] = selection->DSELexicase(matrix, config.LEX_EPS(), test_cases);
+      parent[i] = selection->DSELexicase(matrix, pop.size(), config.LEX_EPS());
     }
 
     return parent;
@@ -1139,14 +1869,12 @@ void DiagWorld::CohortLexicase()
 {
   std::cerr << "Setting selection scheme: CohortLexicase" << std::endl;
 
-  select = [this]()
+  select = [this](const SelectionInputs & in)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
     emp_assert(0 < pop.size()); emp_assert(0 < config.COH_LEX_PROP());
 
-    // fitness matrix
-    const fmatrix_t matrix = PopFitMat();
     // population cohorts
     const cohort_t pop_cohorts = selection->CohortGeneration(config.POP_SIZE(), config.COH_LEX_PROP());
     // testcase cohorts
@@ -1154,6 +1882,13 @@ void DiagWorld::CohortLexicase()
     // quick checks
     emp_assert(pop_cohorts.size() == test_cohorts.size());
 
+    // cohorts are independent, run them side by side
+    if(config.COH_LEX_PARALLEL()) {return ParallelCohorts(pop_cohorts, test_cohorts);}
+
+    // fitness matrix
+    emp_assert(in.scores);
+    const fmatrix_t & matrix = *in.scores;
+
     // select parent ids
     ids_t parent(pop.size());
 
@@ -1184,17 +1919,16 @@ void DiagWorld::NoveltyLexicase()
 {
   std::cerr << "Setting selection scheme: NoveltyLexicase" << std::endl;
 
-  select = [this]()
+  select = [this](const SelectionInputs & in)
   {
     // quick checks
     emp_assert(selection); emp_assert(pop.size() == config.POP_SIZE());
     emp_assert(0 < pop.size()); emp_assert(0 <= config.NOVEL_K());
     emp_assert(0 <= config.LEX_EPS());
 
-    // fitness matrix
-    const fmatrix_t matrix = PopFitMat();
-    // create fitness and novelty value matrix
-    const fmatrix_t t_matrix = selection->LexicaseNoveltyFit(matrix, config.NOVEL_K(), config.OBJECTIVE_CNT());
+    // fitness and novelty value matrix
+    emp_assert(in.novelty);
+    const fmatrix_t & t_matrix = *in.novelty;
 
     // select parent ids
     ids_t parent(pop.size());
@@ -1217,26 +1951,11 @@ void DiagWorld::EcoEA()
 {
   std::cerr << "Setting up selection scheme: EcoEA" << std::endl;
 
-  // Setup ecoea_fitset
-  ecoea_fitset.clear();
-  for (size_t obj_i = 0; obj_i < config.OBJECTIVE_CNT(); ++obj_i) {
-    ecoea_fitset.push_back(
-      [this, obj_i](Org & org) {
-        return org.GetScore()[obj_i];
-      }
-    );
-  }
-  // Setup ecoea resources
-  ecoea_resources.clear();
-  for (size_t res_i = 0; res_i < ecoea_fitset.size(); ++res_i) {
-    ecoea_resources.push_back(
-      emp::Resource(
-        config.RESOURCE_SELECT_RES_INFLOW(),
-        config.RESOURCE_SELECT_RES_INFLOW(),
-        config.RESOURCE_SELECT_RES_OUTFLOW()
-      )
-    );
-  }
+  // one resource per objective, all starting at the inflow (outflow is never applied by the scheme)
+  if(ecoea) {ecoea.Delete();}
+  ecoea = emp::NewPtr<EcoEAEngine>(config.OBJECTIVE_CNT(), config.RESOURCE_SELECT_RES_INFLOW(), config.RESOURCE_SELECT_FRAC(),
+                                   config.RESOURCE_SELECT_MAX_BONUS(), config.RESOURCE_SELECT_COST(), config.RESOURCE_SELECT_NICHE_WIDTH());
+  ecoea->SetLogSpace(config.RESOURCE_SELECT_LOG());
 
   // satisfy requirement for world to have base fitness function
   SetFitFun(
@@ -1246,87 +1965,87 @@ void DiagWorld::EcoEA()
   );
 
   // emp::ResourceSelect(*this, fit_set, resources, TOURNAMENT_SIZE, POP_SIZE, RESOURCE_SELECT_FRAC, RESOURCE_SELECT_MAX_BONUS,RESOURCE_SELECT_COST, true, RESOURCE_SELECT_NICHE_WIDTH);
-  select = [this]() {
+  select = [this](const SelectionInputs &) {
     // @AML: This is implemented by ripping internals of emp::ResourceSelect out and dumping here (to play nice w/fact that selection should just return parent ids instead of handing reproduction).
     //       Trying to make minimal number of changes.
-    emp::vector< std::function<double(Org &)> > & extra_funs = ecoea_fitset;
-    emp::vector<emp::Resource> & pools = ecoea_resources; // TODO
     size_t t_size = config.TOUR_SIZE();
     size_t tourny_count = config.POP_SIZE();
-    double frac = config.RESOURCE_SELECT_FRAC();
-    double max_bonus = config.RESOURCE_SELECT_MAX_BONUS();
-    double cost = config.RESOURCE_SELECT_COST();
-    bool use_base = true;
-    double min_score = config.RESOURCE_SELECT_NICHE_WIDTH();
+    const size_t obj_cnt = config.OBJECTIVE_CNT();
 
     emp_assert(GetFitFun(), "Must define a base fitness function");
     emp_assert(GetSize() > 0);
     emp_assert(t_size > 0, t_size);
 
-    // Setup info to track fitnesses.
-    emp::vector<double> base_fitness(GetSize());
-    emp::vector< emp::vector<double> > extra_fitnesses(extra_funs.size());
-    for (size_t i=0; i < extra_funs.size(); i++) {
-      extra_fitnesses[i].resize(GetSize());
-    }
-
-    // Collect all fitness info.
+    // Collect base fitnesses & scores (into the engine's flat score matrix).
+    emp::vector<double> base_fitness(GetSize(), 0.0);
+    emp::vector<bool> occupied(GetSize(), false);
+    ecoea->Resize(GetSize());
     for (size_t org_id = 0; org_id < GetSize(); org_id++) {
       if (!IsOccupied(org_id)) {
           continue;
       }
-      if (use_base) {
-        base_fitness[org_id] = CalcFitnessID(org_id);
-      } else {
-        base_fitness[org_id] = 0;
-      }
+      occupied[org_id] = true;
+      base_fitness[org_id] = CalcFitnessID(org_id);
 
-      for (size_t ex_id = 0; ex_id < extra_funs.size(); ex_id++) {
-        pools[ex_id].Inc(pools[ex_id].GetInflow()/GetNumOrgs());
-        double cur_fit = extra_funs[ex_id](GetOrg(org_id));
-        cur_fit = emp::Pow(cur_fit, 2.0);
-        cur_fit *= frac*(pools[ex_id].GetAmount()-cost);
-        if (cur_fit > min_score) {
-            cur_fit -= cost;
-        } else {
-            cur_fit = 0;
-        }
-        cur_fit = std::min(cur_fit, max_bonus);
-        extra_fitnesses[ex_id][org_id] = emp::Pow2(cur_fit);
-        base_fitness[org_id] *= emp::Pow2(cur_fit);
-        pools[ex_id].Dec(std::abs(cur_fit));
-      }
+      const score_t & score = GetOrg(org_id).GetScore();
+      emp_assert(score.size() == obj_cnt);
+      std::copy(score.begin(), score.begin() + obj_cnt, ecoea->Row(org_id));
     }
 
-    emp::vector<size_t> entries;
-    ids_t parents(pop.size()); // <- to play nice with other selection schemes
+    // Resource bonuses, consuming resources org by org (log2 fitnesses under RESOURCE_SELECT_LOG).
+    const emp::vector<double> & fitness = ecoea->Fitness(base_fitness, GetNumOrgs(), &occupied);
 
-    for (size_t T = 0; T < tourny_count; T++) {
-      entries.resize(0);
-      for (size_t i=0; i<t_size; i++) entries.push_back( GetRandomOrgID() ); // Allows replacement!
+    // Tournaments with replacement, drawn exactly as GetRandomOrgID() would (same random stream).
+    emp_assert(tourny_count == pop.size());
+    return selection->TournamentBatch(tourny_count, t_size, fitness); // play nice with other selection schemes
+  };
+}
 
-      double best_fit = base_fitness[entries[0]];
-      size_t best_id = entries[0];
+///< evaluation function implementations
 
-      // Search for a higher fit org in the tournament.
-      for (size_t i = 1; i < t_size; i++) {
-        const double cur_fit = base_fitness[entries[i]];
-        if (cur_fit > best_fit) {
-          best_fit = cur_fit;
-          best_id = entries[i];
-        }
-      }
+template <size_t M>
+bool DiagWorld::SetFixedEvaluation(const size_t diag)
+{
+  using fixed_t = FixedDiagnostic<M>;
+  typename fixed_t::kernel_t kernel = nullptr;
 
-      // Place the highest fitness into the next generation!
-      // world.DoBirth( world.GetGenomeAt(best_id), best_id, 1 );
-      parents[T] = best_id;
-    }
+  switch (diag)
+  {
+    case 0: kernel = &fixed_t::Exploitation; break;
+    case 1: kernel = &fixed_t::StructExploitation; break;
+    case 2: kernel = &fixed_t::StrongEcology; break;
+    case 3: kernel = &fixed_t::Exploration; break;
+    case 4: kernel = &fixed_t::WeakEcology; break;
+    default: return false;
+  }
+
+  // both are small, the lambda keeps its own copies
+  const fixed_t fixed(config.TARGET(), config.CREDIT());
+  const double acc = config.ACCURACY();
+
+  evaluate = [fixed, kernel, acc](Org & org)
+  {
+    emp_assert(org.GetGenome().size() == M);
+    const gene_t * g = org.GetGenome().data();
+
+    // set score & aggregate
+    typename fixed_t::score_t score;
+    (fixed.*kernel)(g, score);
+    org.SetScore(score);
+    org.AggregateScore();
+    org.StartPosition();
+
+    // set optimal vector and count
+    typename fixed_t::opti_t opti;
+    fixed.OptimizedVector(g, acc, opti);
+    org.SetOptimal(opti);
+    org.CountOptimized();
 
-    return parents; // play nice with other selection schemes
+    return org.GetAggregate();
   };
-}
 
-///< evaluation function implementations
+  return true;
+}
 
 void DiagWorld::Exploitation()
 {
@@ -1473,19 +2192,6 @@ size_t DiagWorld::UniqueObjective()
   return cnt;
 }
 
-size_t DiagWorld::FindElite()
-{
-  // quick checks
-  emp_assert(0 < fit_vec.size()); emp_assert(fit_vec.size() == pop.size());
-  emp_assert(fit_vec.size() == config.POP_SIZE());
-  emp_assert(elite_pos == config.POP_SIZE());
-
-  // find max value position
-  auto elite_it = std::max_element(fit_vec.begin(), fit_vec.end());
-
-  return std::distance(fit_vec.begin(), elite_it);;
-}
-
 size_t DiagWorld::FindCommon()
 {
   // quick checks
@@ -1538,28 +2244,6 @@ size_t DiagWorld::FindCommon()
   return max_pos;
 }
 
-size_t DiagWorld::FindOptimized()
-{
-  // quick checks
-  emp_assert(0 < pop.size()); emp_assert(pop.size() == config.POP_SIZE());
-  emp_assert(opti_pos == config.POP_SIZE());
-
-  // iterate through pop and find optimal solution
-  size_t max = 0; size_t max_pos = 0;
-  for(size_t i = 0; i < pop.size(); ++i)
-  {
-    const Org & org = *pop[i];
-
-    if(max < org.GetCount())
-    {
-      max = org.GetCount();
-      max_pos = i;
-    }
-  }
-
-  return max_pos;
-}
-
 size_t DiagWorld::FindUniqueStart()
 {
   // quick checks
@@ -1583,6 +2267,75 @@ size_t DiagWorld::FindUniqueStart()
   return position.size();
 }
 
+void DiagWorld::FillPopNodes()
+{
+  // quick checks
+  emp_assert(pop.size() == config.POP_SIZE());
+
+  // first max aggregate (elite) and first max optimized count (optimal), as found before
+  size_t elite = 0; size_t opti = 0; size_t max = 0;
+  for(size_t i = 0; i < pop.size(); ++i)
+  {
+    Org & org = *pop[i];
+    pop_fit->Add(org.GetAggregate());
+    pop_opti->Add(org.GetCount());
+
+    if(pop[elite]->GetAggregate() < org.GetAggregate()) {elite = i;}
+    if(max < org.GetCount()) {max = org.GetCount(); opti = i;}
+  }
+  emp_assert(pop_fit->GetCount() == config.POP_SIZE());
+  emp_assert(pop_opti->GetCount() == config.POP_SIZE());
+
+  elite_pos = elite;
+  opti_pos = opti;
+}
+
+void DiagWorld::FillPntNodes()
+{
+  // get parent data
+  emp_assert(parent_vec.size() == config.POP_SIZE());
+  for(size_t i = 0; i < parent_vec.size(); ++i)
+  {
+    Org & org = *pop[parent_vec[i]];
+    pnt_fit->Add(org.GetAggregate());
+    pnt_opti->Add(org.GetCount());
+  }
+  emp_assert(pnt_fit->GetCount() == config.POP_SIZE());
+  emp_assert(pnt_opti->GetCount() == config.POP_SIZE());
+}
+
+size_t DiagWorld::StatClosure(size_t need)
+{
+  // a statistic only reuses ones at lower bits, so one pass from the top picks up chains
+  for(size_t b = STAT_CNT; b-- > 0;)
+  {
+    if(need & (size_t(1) << b)) {need |= STAT_DEPS[b];}
+  }
+
+  return need;
+}
+
+void DiagWorld::TrackStats(const size_t need)
+{
+  const size_t todo = StatClosure(need) & ~stat_done;
+  if(todo == STAT_NONE) {return;}
+
+  // in bit order, so whatever a statistic reuses is ready before it
+  if(todo & STAT_POP_NODES) {FillPopNodes(); stat_done |= STAT_POP_NODES | STAT_ELITE | STAT_OPTIMAL;}
+  if(todo & STAT_PNT_NODES) {FillPntNodes(); stat_done |= STAT_PNT_NODES;}
+  if(todo & STAT_COMMON) {comm_pos = FindCommon(); stat_done |= STAT_COMMON;}
+  if(todo & STAT_UNI_OBJ)
+  {
+    emp_assert(stat_done & STAT_OPTIMAL);
+    const bool all = pop[opti_pos]->GetCount() == config.OBJECTIVE_CNT();
+    uni_obj = all ? config.OBJECTIVE_CNT() : UniqueObjective();
+    stat_done |= STAT_UNI_OBJ;
+  }
+  if(todo & STAT_UNI_START) {uni_start = FindUniqueStart(); stat_done |= STAT_UNI_START;}
+
+  emp_assert((stat_done & StatClosure(need)) == StatClosure(need));
+}
+
 // void DiagWorld::SnapshotPhylogony()
 // {
 //   sys_ptr->Snapshot(config.OUTPUT_DIR() + "phylo_" + emp::to_string(GetUpdate()) + ".csv");
@@ -1593,6 +2346,8 @@ size_t DiagWorld::FindUniqueStart()
 
 DiagWorld::fmatrix_t DiagWorld::PopFitMat()
 {
+  DIA_PHASE(timer, Phase::POP_FIT_MAT);
+
   // quick checks
   emp_assert(pop.size() == config.POP_SIZE());
 
@@ -1611,6 +2366,83 @@ DiagWorld::fmatrix_t DiagWorld::PopFitMat()
   return matrix;
 }
 
+DiagWorld::score_t DiagWorld::PopSampleMat(const ids_t & t_cases)
+{
+  // quick checks
+  emp_assert(pop.size() == config.POP_SIZE()); emp_assert(0 < t_cases.size());
+
+  // column k holds every org's score on testcase t_cases[k]
+  const size_t N = pop.size();
+  score_t matrix(N * t_cases.size());
+
+  for(size_t i = 0; i < N; ++i)
+  {
+    const score_t & score = pop[i]->GetScore();
+    emp_assert(score.size() == config.OBJECTIVE_CNT());
+
+    for(size_t k = 0; k < t_cases.size(); ++k) {matrix[k * N + i] = score[t_cases[k]];}
+  }
+
+  return matrix;
+}
+
+DiagWorld::fmatrix_t DiagWorld::PopSampleRows(const ids_t & t_cases)
+{
+  // quick checks
+  emp_assert(pop.size() == config.POP_SIZE()); emp_assert(0 < t_cases.size());
+
+  // row i holds org i's scores on the sampled testcases, in t_cases order
+  fmatrix_t rows(pop.size(), score_t(t_cases.size()));
+
+  for(size_t i = 0; i < pop.size(); ++i)
+  {
+    const score_t & score = pop[i]->GetScore();
+    emp_assert(score.size() == config.OBJECTIVE_CNT());
+
+    for(size_t k = 0; k < t_cases.size(); ++k) {rows[i][k] = score[t_cases[k]];}
+  }
+
+  return rows;
+}
+
+DiagWorld::ids_t DiagWorld::ParallelCohorts(const cohort_t & pop_cohorts, const cohort_t & test_cohorts)
+{
+  // quick checks
+  emp_assert(pop_cohorts.size() == test_cohorts.size()); emp_assert(pool);
+
+  // parents of cohort p start at offset[p], as in the serial loop
+  ids_t offset(pop_cohorts.size() + 1, 0);
+  for(size_t p = 0; p < pop_cohorts.size(); ++p) {offset[p + 1] = offset[p] + pop_cohorts[p].size();}
+  emp_assert(offset.back() == config.POP_SIZE());
+
+  ids_t parent(pop.size());
+  const size_t gen = GetUpdate();
+
+  pool->ParallelFor(pop_cohorts.size(), [this, &pop_cohorts, &test_cohorts, &offset, &parent, gen](size_t p)
+  {
+    const ids_t & orgs = pop_cohorts[p];
+    const ids_t & tests = test_cohorts[p];
+    const size_t N = orgs.size(), S = tests.size();
+
+    // cohort orgs x cohort testcases, column-major
+    score_t matrix(N * S);
+    for(size_t i = 0; i < N; ++i)
+    {
+      const score_t & score = pop[orgs[i]]->GetScore();
+      for(size_t k = 0; k < S; ++k) {matrix[k * N + i] = score[tests[k]];}
+    }
+
+    // same stream whichever thread runs the cohort
+    CounterRandom stream(run_seed, gen, p, RngPurpose::COHORT);
+    for(size_t c = 0; c < N; ++c)
+    {
+      parent[offset[p] + c] = orgs[selection->DenseLexicase(matrix.data(), N, S, config.LEX_EPS(), stream)];
+    }
+  });
+
+  return parent;
+}
+
 DiagWorld::gmatrix_t DiagWorld::PopGenomes()
 {
   // quick checks
@@ -1645,6 +2477,24 @@ void DiagWorld::SnapshotConfig(const config_t & config) {
     snapshot_file.Update();
   }
 
+  // 1 if checkpoints reseeded the shared generator, so this run differs from one without checkpoints at the same SEED
+  const bool reseeded = config.CHECKPOINT_INTERVAL() && config.RNG_MODE() != 1;
+  get_cur_param = []() { return std::string("CHECKPOINT_RESEEDED"); };
+  get_cur_value = [reseeded]() { return emp::to_string(reseeded); };
+  snapshot_file.Update();
+
+  // build time gene storage type (GENE_FLOAT=1 gives float32)
+  get_cur_param = []() { return std::string("GENE_TYPE"); };
+  get_cur_value = []() { return std::string(GENE_TYPE_NAME); };
+  snapshot_file.Update();
+
+}
+
+void DiagWorld::WriteSnapshot(const std::string & path, const gen_snapshot_t::bytes_t & bytes)
+{
+  if(writer) {writer->WriteFile(path, std::string(bytes.begin(), bytes.end())); return;}
+
+  gen_snapshot_t::WriteFile(path, bytes);
 }
 
 #endif
\ No newline at end of file